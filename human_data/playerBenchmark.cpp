@@ -0,0 +1,392 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <iostream>
+#include <fstream>
+#include <yarp/os/Property.h>
+#include <yarp/os/Time.h>
+#include <yarp/sig/Vector.h>
+
+#include <string>
+#include <vector>
+
+#include "humanData.h"
+#include "jointLimits.h"
+#include "realTime.h"
+#include "trajectoryPlayer.h"
+
+using namespace yarp::os;
+using namespace yarp::sig;
+using namespace std;
+
+//---------------------------------------------------------
+// one step of the pipeline, timed over several iterations after
+// an untimed one (the first reads of the files, the static buffers);
+// the allocations are counted by the operator new of allocationCheck.cpp, linked in this program
+//---------------------------------------------------------
+struct Stage
+{
+	string name;
+	string input;
+	int iterations;
+	int frames;			// processed by one iteration
+	double best;		// s, fastest iteration
+	double total;		// s, all the iterations
+	long allocations;	// during the iterations, all threads
+	long bytes;
+	bool ok;
+	bool boards;		// the commands recorded by the mock boards, of the last iteration
+	MockCommandReport commands;
+};
+
+// the output of the steps is thrown away while they are timed, and
+// also before when the JSON goes to the standard output: the standard
+// output is sent to /dev/null, so that the printf of the library are
+// silenced as well as cout
+class SilentOutput
+{
+public:
+	SilentOutput(bool enabled=true) : saved(-1)
+	{
+		if(!enabled)
+			return;
+		cout.flush();
+		fflush(stdout);
+		int null=open("/dev/null", O_WRONLY);
+		if(null<0)
+			return;
+		saved=dup(STDOUT_FILENO);
+		if(saved>=0)
+			dup2(null, STDOUT_FILENO);
+		::close(null);
+	}
+	~SilentOutput()
+	{
+		if(saved<0)
+			return;
+		cout.flush();
+		fflush(stdout);
+		dup2(saved, STDOUT_FILENO);
+		::close(saved);
+	}
+private:
+	int saved;
+};
+
+static void startStage(Stage &stage, const string &name, const string &input)
+{
+	stage.name=name;
+	stage.input=input;
+	stage.iterations=0;
+	stage.frames=0;
+	stage.best=0.0;
+	stage.total=0.0;
+	stage.allocations=0;
+	stage.bytes=0;
+	stage.ok=false;
+	stage.boards=false;
+}
+
+static void addIteration(Stage &stage, int frames, double elapsed, long allocations, long bytes)
+{
+	if(stage.iterations==0 || elapsed<stage.best)
+		stage.best=elapsed;
+	stage.iterations++;
+	stage.frames=frames;
+	stage.total+=elapsed;
+	stage.allocations+=allocations;
+	stage.bytes+=bytes;
+	stage.ok=true;
+}
+
+// step() returns the frames it processed, <0 on error
+template<class Step> bool runStage(Stage &stage, int iterations, bool quiet, Step step)
+{
+	{
+		SilentOutput silent(quiet);
+		if(step()<0)
+			return false;
+	}
+	
+	SilentOutput silent;
+	for(int k=0; k<iterations; k++)
+	{
+		long allocations0=allocations(), bytes0=allocatedBytes();
+		double start=Time::now();
+		int frames=step();
+		double elapsed=Time::now()-start;
+		if(frames<0)
+		{
+			stage.ok=false;
+			return false;
+		}
+		addIteration(stage, frames, elapsed, allocations()-allocations0, allocatedBytes()-bytes0);
+	}
+	return true;
+}
+
+// a JSON string, the file names may have quotes or backslashes
+static string jsonString(const string &text)
+{
+	string quoted="\"";
+	for(size_t k=0; k<text.size(); k++)
+	{
+		unsigned char c=text[k];
+		if(c=='"' || c=='\\')
+		{
+			quoted+='\\';
+			quoted+=c;
+		}
+		else if(c<0x20)
+		{
+			char escaped[8];
+			snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+			quoted+=escaped;
+		}
+		else
+			quoted+=c;
+	}
+	return quoted+"\"";
+}
+
+static void writeJson(ostream &out, const vector<Stage> &stages)
+{
+	out<<"{"<<endl
+		<<"  \"benchmark\": \"playerBenchmark\","<<endl
+		<<"  \"stages\": ["<<endl;
+	for(size_t k=0; k<stages.size(); k++)
+	{
+		const Stage &s=stages[k];
+		int n=s.iterations>0 ? s.iterations : 1;
+		out<<"    { \"name\": "<<jsonString(s.name)<<", \"input\": "<<jsonString(s.input)<<", \"ok\": "<<(s.ok ? "true" : "false")
+			<<", \"iterations\": "<<s.iterations<<", \"frames\": "<<s.frames
+			<<", \"seconds\": "<<s.best<<", \"mean_seconds\": "<<s.total/n
+			<<", \"fps\": "<<(s.best>0.0 ? s.frames/s.best : 0.0)
+			<<", \"allocations\": "<<s.allocations/n<<", \"allocated_bytes\": "<<s.bytes/n;
+		if(s.boards)
+			out<<", \"commands\": "<<s.commands.commands<<", \"dropped_commands\": "<<s.commands.dropped
+				<<", \"sends\": "<<s.commands.sends<<", \"send_interval\": "<<s.commands.meanInterval
+				<<", \"worst_send_interval\": "<<s.commands.worstInterval;
+		out<<" }"
+			<<(k+1<stages.size() ? "," : "")<<endl;
+	}
+	out<<"  ]"<<endl
+		<<"}"<<endl;
+}
+
+//==============================================================
+//
+//		MAIN
+//
+//==============================================================
+int main(int argc, char *argv[]) 
+{
+	string jointAnglesName="jointAngles_noheader.txt";
+	string rigidBodyName="sit2stand-rigid.txt";
+	string limitsName;
+	string outputName;
+	int iterations=20;
+	int playbacks=3;
+	bool directMode=false;
+	
+	Property params;
+	params.fromCommand(argc, argv);
+	
+	if (params.check("help"))
+	{
+		cout<<"This tool times the steps of the player pipeline and writes them as JSON, to compare the releases."<<endl
+			<<" Usage:   playerBenchmark --file FILENAME --rigid RIGIDFILE --limits LIMITS --iterations N --playbacks P --mode MODE --out OUTPUT"<<endl
+			<<" FILENAME is the joint angles (jointAngles_noheader.txt), RIGIDFILE the raw rigid bodies capture (sit2stand-rigid.txt)"<<endl
+			<<" LIMITS is a joint limits file (see jointLimits.ini), the sit-to-stand limits otherwise"<<endl
+			<<" N is the timed iterations of the parsing, retargeting, joint limits check and saturation, P the timed playbacks"<<endl
+			<<" MODE is position or direct, the playback is on mock_controlboard with a virtual clock"<<endl
+			<<" OUTPUT is the JSON file, the standard output otherwise"<<endl
+			<<" Every stage reports its frames per second (fastest iteration) and its allocations per iteration,"<<endl
+			<<" the playback also the commands recorded by the boards (sent, dropped, interval between two sends)"<<endl
+			<<" Default values: file=jointAngles_noheader.txt rigid=sit2stand-rigid.txt iterations=20 playbacks=3 mode=position"<<endl;
+		return 1;
+	}
+	
+	if (params.check("file"))
+		jointAnglesName=params.find("file").asString().c_str();
+	if (params.check("rigid"))
+		rigidBodyName=params.find("rigid").asString().c_str();
+	if (params.check("limits"))
+		limitsName=params.find("limits").asString().c_str();
+	if (params.check("out"))
+		outputName=params.find("out").asString().c_str();
+	if (params.check("iterations"))
+		iterations=params.find("iterations").asInt();
+	if (params.check("playbacks"))
+		playbacks=params.find("playbacks").asInt();
+	if (params.check("mode"))
+		directMode=(params.find("mode").asString()=="direct");
+	if(iterations<1 || playbacks<1)
+	{
+		cout<<"ERROR: iterations and playbacks must be >0"<<endl;
+		return -1;
+	}
+	
+	JointLimits limits;
+	defaultJointLimits(limits);
+	if(!limitsName.empty() && !loadJointLimits(limitsName, limits))
+		return -1;
+	
+	// the JSON alone on the standard output
+	bool quiet=outputName.empty();
+	vector<Stage> stages(7);
+	bool ok=true;
+	
+	//--------------- PARSING  --------------
+	
+	HumanData human;
+	startStage(stages[0], "parse_joint_angles", jointAnglesName);
+	ok=runStage(stages[0], iterations, quiet, [&]()
+	{
+		HumanData data;
+		return loadFileHumanData(jointAnglesName, data) ? data.numberOfFrames() : -1;
+	});
+	{
+		SilentOutput silent;
+		ok=ok && loadFileHumanData(jointAnglesName, human);
+	}
+	
+	startStage(stages[1], "parse_rigid_bodies", rigidBodyName);
+	ok=runStage(stages[1], iterations, quiet, [&]()
+	{
+		HumanData data;
+		return loadFileRigidBody(rigidBodyName, 0.0, data) ? data.numberOfFrames() : -1;
+	}) && ok;
+	
+	//--------------- RETARGETING  --------------
+	
+	// the encoders of the iCub parts, at zero
+	Vector q_RA(16, 0.0), q_LA(16, 0.0), q_T(3, 0.0), q_RL(6, 0.0), q_LL(6, 0.0);
+	WholeBodyTrajectory traj;
+	startStage(stages[2], "retarget", jointAnglesName);
+	if(ok)
+		ok=runStage(stages[2], iterations, quiet, [&]()
+		{
+			return loadHumanDataOnRobotTrajectory(human, q_RA, q_LA, q_T, q_RL, q_LL, traj) ? traj.numberOfFrames() : -1;
+		});
+	
+	//--------------- SAFETY CHECK  --------------
+	
+	// the check of the player: the whole trajectory once before playing
+	// (checkJointLimits), on a copy of the retargeted one so that every
+	// iteration saturates the same frames, the copy being timed too
+	WholeBodyTrajectory checked;
+	JointLimitsReport report;
+	startStage(stages[3], "check_joint_limits", jointAnglesName);
+	if(ok)
+		ok=runStage(stages[3], iterations, quiet, [&]()
+		{
+			int n=traj.numberOfFrames();
+			if(checked.numberOfFrames()!=n && !checked.resize(n))
+				return -1;
+			memcpy(checked.frame(0), traj.frame(0), (size_t)n*WholeBodyTrajectory::frameStride*sizeof(double));
+			checkJointLimits(checked, 0, limits, report);
+			return n;
+		});
+	
+	// then every command of the playing loop (saturateFrame), here the
+	// frames before the check
+	alignas(64) double command[WholeBodyTrajectory::frameStride];
+	startStage(stages[4], "saturate_frame", jointAnglesName);
+	if(ok)
+		ok=runStage(stages[4], iterations, quiet, [&]()
+		{
+			for(int t=0; t<traj.numberOfFrames(); t++)
+			{
+				memcpy(command, traj.frame(t), sizeof(command));
+				saturateFrame(command, limits);
+			}
+			return traj.numberOfFrames();
+		});
+	
+	//--------------- PLAYBACK  --------------
+	
+	// the whole pipeline of bodyPlayer on the mock boards, as fast as
+	// the virtual clock allows: load to approach is one stage, play the other
+	TrajectoryPlayerOptions options;
+	options.name="/playerBenchmark";
+	options.device="mock_controlboard";
+	options.virtualClock=true;
+	options.verbosity=0;
+	options.directMode=directMode;
+	
+	startStage(stages[5], "playback_setup", jointAnglesName);
+	startStage(stages[6], directMode ? "playback_direct" : "playback_position", jointAnglesName);
+	for(int k=0; k<=playbacks && ok; k++)
+	{
+		// the first one is not timed
+		bool timed=(k>0);
+		SilentOutput silent(timed || quiet);
+		
+		long allocations0=allocations(), bytes0=allocatedBytes();
+		double start=Time::now();
+		TrajectoryPlayer player(options);
+		ok=(limitsName.empty() || player.loadLimits(limitsName)) && player.load(jointAnglesName) && player.open() && player.retarget();
+		if(!ok)
+			break;
+		player.check();
+		ok=player.approach();
+		if(!ok)
+			break;
+		int frames=player.trajectory().numberOfFrames();
+		if(timed)
+			addIteration(stages[5], frames, Time::now()-start, allocations()-allocations0, allocatedBytes()-bytes0);
+		
+		allocations0=allocations();
+		bytes0=allocatedBytes();
+		start=Time::now();
+		ok=player.play();
+		if(ok && timed)
+		{
+			addIteration(stages[6], frames-options.first, Time::now()-start, allocations()-allocations0, allocatedBytes()-bytes0);
+			stages[6].boards=player.commandReport(stages[6].commands);
+		}
+	}
+	
+	//--------------- RESULTS  --------------
+	
+	if(outputName.empty())
+		writeJson(cout, stages);
+	else
+	{
+		ofstream output(outputName.c_str());
+		if(!output)
+		{
+			cout<<"ERROR: Can't write "<<outputName<<endl;
+			return -1;
+		}
+		writeJson(output, stages);
+		cout<<"Written "<<outputName<<endl;
+	}
+	
+	if(!ok)
+	{
+		cout<<"ERROR: a stage failed (\"ok\": false), run with --out to see its messages"<<endl;
+		return -1;
+	}
+	return 0;
+}
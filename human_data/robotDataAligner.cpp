@@ -0,0 +1,135 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+
+#include <stdio.h>
+#include <iostream>
+#include <yarp/os/Property.h>
+#include <yarp/os/Time.h>
+#include <yarp/sig/Matrix.h>
+#include <yarp/sig/Vector.h>
+
+#include <string>
+#include <vector>
+
+#include "robotData.h"
+#include "binaryTrajectory.h"
+
+using namespace yarp::sig;
+using namespace yarp::os;
+using namespace std;
+
+//==============================================================
+//
+//		MAIN
+//
+//==============================================================
+int main(int argc, char *argv[]) 
+{
+	string directory, outputName;
+	double period;
+	double start, end;
+	
+	Property params;
+	params.fromCommand(argc, argv);
+	
+	if (params.check("help") || !params.check("dir") || !params.check("out"))
+	{
+		cout<<"This tool merges the yarpdatadumper logs of a recording in one whole-body table on a common time grid."<<endl
+			<<" Usage:   robotDataAligner --dir DIRECTORY --out FILENAME --period SECONDS --binary --from START --to END"<<endl
+			<<" DIRECTORY is a recording such as robot_data/seat_on_chair, with one sub-directory per part"<<endl
+			<<" Default period is the median sampling period of the logs; --binary writes a binary trajectory instead of text"<<endl
+			<<" START and END restrict the logs to a window of their timestamps (e.g. --from 1475070160 --to 1475070170);"<<endl
+			<<" only the rows of the window are read, found with the index data.log.idx built next to each log at the first use"<<endl;
+		return 1;
+	}
+	
+	directory=params.find("dir").asString().c_str();
+	outputName=params.find("out").asString().c_str();
+	period=params.check("period") ? params.find("period").asDouble() : 0.0;
+	start=params.check("from") ? params.find("from").asDouble() : -HUGE_VAL;
+	end=params.check("to") ? params.find("to").asDouble() : HUGE_VAL;
+	if(start>end)
+	{
+		cout<<"ERROR: the window starts after its end"<<endl;
+		return -1;
+	}
+	
+	double t0=Time::now();
+	vector<DumperLog> logs;
+	if(!loadRobotData(directory, logs, start, end))
+	{
+		cout<<"Errors in loading "<<directory<<". Closing."<<endl;
+		return -1;
+	}
+	double t1=Time::now();
+	for(size_t k=0; k<logs.size(); k++)
+		cout<<" "<<logs[k].part<<" ("<<logs[k].port<<"): "<<logs[k].numberOfSamples()<<" samples of "<<logs[k].nValues<<" values"<<endl;
+	
+	Vector time;
+	Matrix table;
+	vector<string> names;
+	if(!alignRobotData(logs, period, time, table, names))
+		return -1;
+	double t2=Time::now();
+	
+	int nRows=table.rows();
+	int nColumns=table.cols();
+	cout<<"Aligned "<<nRows<<" frames of "<<nColumns<<" values, period "<<(nRows>1 ? time[1]-time[0] : 0.0)<<" s"<<endl
+		<<" loading "<<(t1-t0)*1000.0<<" ms, alignment "<<(t2-t1)*1000.0<<" ms"<<endl;
+	
+	if(params.check("binary"))
+	{
+		// column-major, with the time as first column
+		vector<double> data((nColumns+1)*nRows);
+		vector<const double *> columns;
+		names.insert(names.begin(), "time");
+		for(int c=0; c<=nColumns; c++)
+		{
+			double *column=&data[c*nRows];
+			for(int r=0; r<nRows; r++)
+				column[r] = (c==0) ? time[r] : table[r][c-1];
+			columns.push_back(column);
+		}
+		double rate = nRows>1 ? 1.0/(time[1]-time[0]) : 0.0;
+		if(!writeBinaryTrajectory(outputName, rate, names, columns, nRows))
+			return -1;
+	}
+	else
+	{
+		FILE *out=fopen(outputName.c_str(), "w");
+		if(!out)
+		{
+			cout<<"ERROR: Can't write file: "<<outputName<<endl;
+			return -1;
+		}
+		fprintf(out, "time");
+		for(int c=0; c<nColumns; c++)
+			fprintf(out, " %s", names[c].c_str());
+		fprintf(out, "\n");
+		for(int r=0; r<nRows; r++)
+		{
+			fprintf(out, "%.6f", time[r]);
+			for(int c=0; c<nColumns; c++)
+				fprintf(out, " %g", table[r][c]);
+			fprintf(out, "\n");
+		}
+		fclose(out);
+	}
+	
+	cout<<"Written "<<outputName<<endl;
+	return 0;
+}
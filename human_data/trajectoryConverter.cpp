@@ -0,0 +1,100 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+
+#include <stdio.h>
+#include <iostream>
+#include <yarp/os/Property.h>
+
+#include <string>
+#include <vector>
+
+#include "humanData.h"
+#include "binaryTrajectory.h"
+#include "rigidBodyReader.h"
+
+using namespace yarp::os;
+using namespace std;
+
+//==============================================================
+//
+//		MAIN
+//
+//==============================================================
+int main(int argc, char *argv[]) 
+{
+	string inputName, outputName;
+	double rate;
+	
+	Property params;
+	params.fromCommand(argc, argv);
+	
+	if (params.check("help") || !params.check("in") || (!params.check("out") && !params.check("reference")))
+	{
+		cout<<"This tool converts a human trajectory to the binary format mapped by bodyPlayer."<<endl
+			<<" Usage:   trajectoryConverter --in FILENAME --out FILENAME --rate HZ [--reference REFERENCE [--tolerance DEG]]"<<endl
+			<<" FILENAME is the joint angles (jointAngles_noheader.txt, jointAngles.csv) or the raw rigid bodies capture (sit2stand-rigid.txt)"<<endl
+			<<" The rigid bodies are kept at their capture rate unless --rate is given; the joint angles have no rate, default 10 Hz"<<endl
+			<<" REFERENCE are joint angles of the same motion at the rate of the capture (jointAngles_noheader.txt for sit2stand-rigid.txt):"<<endl
+			<<"           the joints computed from the rigid bodies must be within DEG degrees rms of them (default 6), --out is then optional"<<endl;
+		return 1;
+	}
+	
+	inputName=params.find("in").asString().c_str();
+	outputName=params.check("out") ? params.find("out").asString().c_str() : "";
+	rate=params.check("rate") ? params.find("rate").asDouble() : 0.0;
+	
+	HumanData data;
+	if(!loadHumanData(inputName, rate, data))
+	{
+		cout<<"Errors in loading "<<inputName<<". Closing."<<endl;
+		return -1;
+	}
+	if(data.rate<=0.0)
+		data.rate = rate>0.0 ? rate : 10.0;
+	
+	if(params.check("reference"))
+	{
+		HumanData reference;
+		double tolerance=params.check("tolerance") ? params.find("tolerance").asDouble() : 6.0;
+		if(!RigidBodyReader::isRigidBodyFile(inputName))
+		{
+			cout<<"ERROR: --reference checks a rigid bodies capture, "<<inputName<<" is not one"<<endl;
+			return -1;
+		}
+		if(!loadFileHumanData(params.find("reference").asString().c_str(), reference) || !checkRigidBodyJoints(data, reference, tolerance))
+			return -1;
+		if(outputName.empty())
+			return 0;
+	}
+	
+	vector<string> names(humanJointNames, humanJointNames+nHumanJoints);
+	// a binary input stays mapped and is decimated by value(): the columns are gathered
+	vector<vector<double> > values(nHumanJoints, vector<double>(data.numberOfFrames()));
+	vector<const double *> columns;
+	for(int k=0; k<nHumanJoints; k++)
+	{
+		for(int t=0; t<data.numberOfFrames(); t++)
+			values[k][t] = data.value(k, t);
+		columns.push_back(values[k].data());
+	}
+	
+	if(!writeBinaryTrajectory(outputName, data.rate, names, columns, data.numberOfFrames()))
+		return -1;
+	
+	cout<<"Written "<<outputName<<": "<<data.numberOfFrames()<<" frames of "<<nHumanJoints<<" joints at "<<data.rate<<" Hz"<<endl;
+	return 0;
+}
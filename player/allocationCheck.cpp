@@ -0,0 +1,102 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+//---------------------------------------------------------
+// operator new of the programs that check the allocations of the
+// playing loop (see NoAllocationScope). It is compiled in the
+// programs, not in the library: linking it replaces the operator new
+// of the whole process.
+// The first allocations of a NoAllocationScope are reported at the
+// call, with the call stack, on stderr. They are not aborted:
+// stopping the robot in the middle of a movement would be worse than
+// the jitter of an allocation, unless the program is built with
+// PLAYER_ABORT_ON_ALLOCATION (e.g. to find them in simulation).
+//---------------------------------------------------------
+
+#include "realTime.h"
+
+#include <execinfo.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <new>
+
+static const int maxReports = 8;
+static int nReports = 0;
+static thread_local bool reporting = false;
+
+static void writeString(const char *s)
+{
+    ssize_t ignored = write(STDERR_FILENO, s, strlen(s));
+    (void)ignored;
+}
+
+// the call stack on stderr, without allocating
+static void reportAllocation(size_t size)
+{
+    if(reporting || __sync_fetch_and_add(&nReports, 1)>=maxReports)
+        return;
+    reporting = true;
+
+    char line[96];
+    int n = 0;
+    const char *text = "ERROR: allocation of ";
+    memcpy(line, text, strlen(text));
+    n = strlen(text);
+    char digits[24];
+    int d = 0;
+    do { digits[d++] = '0'+size%10; size /= 10; } while(size>0);
+    while(d>0)
+        line[n++] = digits[--d];
+    text = " bytes in the playing loop, at:\n";
+    memcpy(line+n, text, strlen(text)+1);
+    writeString(line);
+
+    void *stack[32];
+    int depth = backtrace(stack, 32);
+    backtrace_symbols_fd(stack+2, depth>2 ? depth-2 : 0, STDERR_FILENO);
+
+    reporting = false;
+#ifdef PLAYER_ABORT_ON_ALLOCATION
+    abort();
+#endif
+}
+
+// backtrace() loads its unwinder on the first call: done here, not in the loop
+static struct AllocationCheck
+{
+    AllocationCheck()
+    {
+        void *stack[2];
+        backtrace(stack, 2);
+        setAllocationsCounted();
+    }
+} allocationCheck;
+
+void *operator new(size_t size)
+{
+    if(countAllocation(size))
+        reportAllocation(size);
+    void *p = malloc(size ? size : 1);
+    if(!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
@@ -0,0 +1,204 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#include "binaryTrajectory.h"
+
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <iostream>
+
+using namespace std;
+
+// the header is written and mapped as is
+typedef char headerSizeCheck[sizeof(BinaryTrajectoryHeader)==64 ? 1 : -1];
+
+static bool isLittleEndian()
+{
+    const uint16_t one=1;
+    return *reinterpret_cast<const uint8_t *>(&one)==1;
+}
+
+static uint64_t alignUp(uint64_t n)
+{
+    return (n+BINARY_TRAJECTORY_ALIGN-1)/BINARY_TRAJECTORY_ALIGN*BINARY_TRAJECTORY_ALIGN;
+}
+
+//---------------------------------------------------------
+// BinaryTrajectory
+//---------------------------------------------------------
+BinaryTrajectory::BinaryTrajectory() : nFrames(0), frameRate(0.0)
+{
+}
+
+bool BinaryTrajectory::isBinaryTrajectoryFile(const string &filename)
+{
+    FILE *f = fopen(filename.c_str(), "rb");
+    if(!f)
+        return false;
+    char magic[8];
+    size_t n = fread(magic, 1, sizeof(magic), f);
+    fclose(f);
+    return n==sizeof(magic) && memcmp(magic, BINARY_TRAJECTORY_MAGIC, sizeof(magic))==0;
+}
+
+bool BinaryTrajectory::open(const string &filename)
+{
+    close();
+
+    if(!isLittleEndian())
+    {
+        cout<<"ERROR: binary trajectories are little endian only"<<endl;
+        return false;
+    }
+    if(!file.open(filename))
+    {
+        cout<<"ERROR: Can't open file: "<<filename<<endl;
+        return false;
+    }
+
+    const BinaryTrajectoryHeader *header = reinterpret_cast<const BinaryTrajectoryHeader *>(file.begin());
+    if(file.size()<sizeof(BinaryTrajectoryHeader) || memcmp(header->magic, BINARY_TRAJECTORY_MAGIC, 8)!=0)
+    {
+        cout<<"ERROR: "<<filename<<" is not a binary trajectory"<<endl;
+        close();
+        return false;
+    }
+    if(header->version>BINARY_TRAJECTORY_VERSION)
+    {
+        cout<<"ERROR: "<<filename<<" has version "<<header->version<<", this player reads up to "<<BINARY_TRAJECTORY_VERSION<<endl;
+        close();
+        return false;
+    }
+
+    // everything the header points to must be in the file; the sizes
+    // are divided, not multiplied, so that a corrupted header cannot
+    // overflow them
+    uint64_t stride = header->columnStride;
+    if(header->namesOffset<sizeof(BinaryTrajectoryHeader) || header->namesOffset>header->dataOffset
+        || header->dataOffset>file.size() || header->dataOffset%BINARY_TRAJECTORY_ALIGN!=0
+        || stride%BINARY_TRAJECTORY_ALIGN!=0 || header->nFrames>stride/sizeof(double)
+        || header->nFrames>(uint64_t)INT_MAX
+        || (stride>0 && header->nJoints>(file.size()-header->dataOffset)/stride))
+    {
+        cout<<"ERROR: "<<filename<<" is truncated or corrupted"<<endl;
+        close();
+        return false;
+    }
+
+    // the period of the frames is 1/rate (also false for a NaN)
+    if(!(header->rate>0.0 && header->rate<HUGE_VAL))
+    {
+        cout<<"ERROR: "<<filename<<" has an invalid rate "<<header->rate<<endl;
+        close();
+        return false;
+    }
+
+    const char *p = file.begin()+header->namesOffset;
+    const char *namesEnd = file.begin()+header->dataOffset;
+    for(uint32_t j=0; j<header->nJoints; j++)
+    {
+        const char *q = static_cast<const char *>(memchr(p, '\0', namesEnd-p));
+        if(!q)
+        {
+            cout<<"ERROR: "<<filename<<" has a corrupted joint name table"<<endl;
+            close();
+            return false;
+        }
+        names.push_back(string(p, q));
+        columns.push_back(reinterpret_cast<const double *>(file.begin()+header->dataOffset+j*stride));
+        p = q+1;
+    }
+
+    nFrames = (int)header->nFrames;
+    frameRate = header->rate;
+    return true;
+}
+
+void BinaryTrajectory::close()
+{
+    file.close();
+    nFrames = 0;
+    frameRate = 0.0;
+    names.clear();
+    columns.clear();
+}
+
+int BinaryTrajectory::findJoint(const string &name) const
+{
+    for(size_t j=0; j<names.size(); j++)
+        if(names[j]==name)
+            return (int)j;
+    return -1;
+}
+
+//---------------------------------------------------------
+// writer
+//---------------------------------------------------------
+bool writeBinaryTrajectory(const string &filename, double rate,
+                           const vector<string> &names,
+                           const vector<const double *> &columns, int nFrames)
+{
+    if(!isLittleEndian())
+    {
+        cout<<"ERROR: binary trajectories are little endian only"<<endl;
+        return false;
+    }
+
+    uint64_t namesSize=0;
+    for(size_t j=0; j<names.size(); j++)
+        namesSize += names[j].size()+1;
+
+    BinaryTrajectoryHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BINARY_TRAJECTORY_MAGIC, 8);
+    header.version = BINARY_TRAJECTORY_VERSION;
+    header.nJoints = (uint32_t)names.size();
+    header.nFrames = nFrames;
+    header.rate = rate;
+    header.namesOffset = sizeof(header);
+    header.dataOffset = alignUp(sizeof(header)+namesSize);
+    header.columnStride = alignUp(nFrames*sizeof(double));
+
+    FILE *f = fopen(filename.c_str(), "wb");
+    if(!f)
+    {
+        cout<<"ERROR: Can't write file: "<<filename<<endl;
+        return false;
+    }
+
+    static const char zeros[BINARY_TRAJECTORY_ALIGN] = {0};
+    bool ok = fwrite(&header, sizeof(header), 1, f)==1;
+    for(size_t j=0; ok && j<names.size(); j++)
+        ok = fwrite(names[j].c_str(), names[j].size()+1, 1, f)==1;
+    uint64_t pad = header.dataOffset-sizeof(header)-namesSize;
+    if(ok && pad>0)
+        ok = fwrite(zeros, pad, 1, f)==1;
+    for(size_t j=0; ok && j<columns.size(); j++)
+    {
+        if(nFrames>0)
+            ok = fwrite(columns[j], sizeof(double), nFrames, f)==(size_t)nFrames;
+        pad = header.columnStride-nFrames*sizeof(double);
+        if(ok && pad>0)
+            ok = fwrite(zeros, pad, 1, f)==1;
+    }
+    ok = (fclose(f)==0) && ok;
+
+    if(!ok)
+        cout<<"ERROR: while writing "<<filename<<endl;
+    return ok;
+}
@@ -0,0 +1,87 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#ifndef BINARY_TRAJECTORY_H
+#define BINARY_TRAJECTORY_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "mappedFile.h"
+
+//---------------------------------------------------------
+// binary trajectory file, little endian:
+//   header (64 bytes)
+//   joint names, each one '\0' terminated
+//   one column of nFrames float64 per joint, every column
+//   starting on a 64 bytes boundary
+// written by trajectoryConverter, mapped as is by the player
+//---------------------------------------------------------
+#define BINARY_TRAJECTORY_MAGIC "ICUBTRAJ"
+#define BINARY_TRAJECTORY_VERSION 1
+#define BINARY_TRAJECTORY_ALIGN 64
+
+struct BinaryTrajectoryHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t nJoints;
+    uint64_t nFrames;
+    double rate;            // Hz
+    uint64_t namesOffset;   // bytes from the start of the file
+    uint64_t dataOffset;
+    uint64_t columnStride;  // bytes between two columns
+    uint8_t reserved[8];
+};
+
+class BinaryTrajectory
+{
+public:
+    BinaryTrajectory();
+
+    // true if the file starts with the binary trajectory magic
+    static bool isBinaryTrajectoryFile(const std::string &filename);
+
+    // map the file and check the header; nothing is copied
+    bool open(const std::string &filename);
+    void close();
+
+    int numberOfJoints() const { return (int)names.size(); }
+    int numberOfFrames() const { return nFrames; }
+    double rate() const { return frameRate; }
+    const std::string &jointName(int j) const { return names[j]; }
+
+    // index of a joint by name, -1 if missing
+    int findJoint(const std::string &name) const;
+
+    // nFrames values of joint j, read straight from the mapping
+    const double *column(int j) const { return columns[j]; }
+
+private:
+    MappedFile file;
+    int nFrames;
+    double frameRate;
+    std::vector<std::string> names;
+    std::vector<const double *> columns;
+};
+
+// write nFrames values of each column
+bool writeBinaryTrajectory(const std::string &filename, double rate,
+                           const std::vector<std::string> &names,
+                           const std::vector<const double *> &columns, int nFrames);
+
+#endif
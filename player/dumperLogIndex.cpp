@@ -0,0 +1,182 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+
+#include "dumperLogIndex.h"
+#include "mappedFile.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <iostream>
+
+using namespace std;
+
+// the header is written and read as is
+typedef char indexHeaderSizeCheck[sizeof(DumperLogIndexHeader)==64 ? 1 : -1];
+
+DumperLogIndex::DumperLogIndex()
+{
+    memset(&header, 0, sizeof(header));
+}
+
+bool DumperLogIndex::open(const string &dataName, int stride)
+{
+    struct stat st;
+    if(stat(dataName.c_str(), &st)!=0)
+    {
+        cout<<"ERROR: Can't open file: "<<dataName<<endl;
+        return false;
+    }
+
+    string indexName = dataName+".idx";
+    if(read(indexName) && header.dataSize==(uint64_t)st.st_size && header.dataTime==(int64_t)st.st_mtime)
+        return true;
+
+    if(!build(dataName, stride))
+        return false;
+    header.dataSize = st.st_size;
+    header.dataTime = st.st_mtime;
+    if(!write(indexName))
+        cout<<"WARNING: Can't write the index "<<indexName<<", it is rebuilt at every use"<<endl;
+    return true;
+}
+
+bool DumperLogIndex::read(const string &indexName)
+{
+    FILE *f = fopen(indexName.c_str(), "rb");
+    if(!f)
+        return false;
+    struct stat st;
+    bool ok = fstat(fileno(f), &st)==0
+              && fread(&header, sizeof(header), 1, f)==1
+              && memcmp(header.magic, DUMPER_LOG_INDEX_MAGIC, 8)==0
+              && header.version==DUMPER_LOG_INDEX_VERSION;
+    // the entries must be the rest of the file, a truncated or corrupted
+    // index is rebuilt
+    if(ok)
+    {
+        uint64_t rest = (uint64_t)st.st_size-sizeof(header);
+        ok = header.nEntries==rest/sizeof(DumperLogIndexEntry) && rest%sizeof(DumperLogIndexEntry)==0;
+    }
+    if(ok)
+    {
+        entries.resize(header.nEntries);
+        ok = header.nEntries==0 || fread(&entries[0], sizeof(DumperLogIndexEntry), header.nEntries, f)==header.nEntries;
+    }
+    fclose(f);
+    return ok;
+}
+
+bool DumperLogIndex::write(const string &indexName) const
+{
+    FILE *f = fopen(indexName.c_str(), "wb");
+    if(!f)
+        return false;
+    bool ok = fwrite(&header, sizeof(header), 1, f)==1;
+    if(ok && !entries.empty())
+        ok = fwrite(&entries[0], sizeof(DumperLogIndexEntry), entries.size(), f)==entries.size();
+    ok = (fclose(f)==0) && ok;
+    if(!ok)
+        remove(indexName.c_str());
+    return ok;
+}
+
+//---------------------------------------------------------
+// one pass on the sequence numbers and timestamps
+//---------------------------------------------------------
+bool DumperLogIndex::build(const string &dataName, int stride)
+{
+    MappedFile file;
+    if(!file.open(dataName))
+    {
+        cout<<"ERROR: Can't open file: "<<dataName<<endl;
+        return false;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, DUMPER_LOG_INDEX_MAGIC, 8);
+    header.version = DUMPER_LOG_INDEX_VERSION;
+    header.stride = stride>0 ? stride : 64;
+    entries.clear();
+
+    const char *p = file.begin();
+    const char *end = file.end();
+    double greatest = -HUGE_VAL;
+    uint64_t rows = 0;
+    while(p<end)
+    {
+        const char *row = p;
+        skipBlanks(p, end);
+        if(p==end || *p=='\n')
+        {
+            skipLine(p, end);
+            continue;
+        }
+
+        double seq, timestamp;
+        if(!parseDouble(p, end, seq) || !parseDouble(p, end, timestamp))
+            break;
+        skipLine(p, end);
+
+        if(rows%header.stride==0)
+        {
+            DumperLogIndexEntry e;
+            e.before = greatest;
+            e.offset = row-file.begin();
+            entries.push_back(e);
+        }
+        if(rows==0)
+            header.firstTimestamp = timestamp;
+        greatest = max(greatest, timestamp);
+        rows++;
+    }
+
+    header.nEntries = entries.size();
+    header.nRows = rows;
+    header.lastTimestamp = rows>0 ? greatest : 0.0;
+    return true;
+}
+
+//---------------------------------------------------------
+// queries: the entries are in the order of before
+//---------------------------------------------------------
+static bool beforeLess(const DumperLogIndexEntry &e, double t)
+{
+    return e.before<t;
+}
+
+static bool beforeGreater(double t, const DumperLogIndexEntry &e)
+{
+    return t<e.before;
+}
+
+const DumperLogIndexEntry &DumperLogIndex::find(double start) const
+{
+    static const DumperLogIndexEntry first = { -HUGE_VAL, 0 };
+    // the last entry with before < start
+    vector<DumperLogIndexEntry>::const_iterator e = lower_bound(entries.begin(), entries.end(), start, beforeLess);
+    return e==entries.begin() ? first : *(e-1);
+}
+
+uint64_t DumperLogIndex::end(double end) const
+{
+    // the first entry with before > end
+    vector<DumperLogIndexEntry>::const_iterator e = upper_bound(entries.begin(), entries.end(), end, beforeGreater);
+    return e==entries.end() ? header.dataSize : e->offset;
+}
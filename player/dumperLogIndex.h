@@ -0,0 +1,87 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+
+#ifndef DUMPER_LOG_INDEX_H
+#define DUMPER_LOG_INDEX_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+//---------------------------------------------------------
+// timestamp index of a data.log of yarpdatadumper, stored next to
+// it as data.log.idx, little endian:
+//   header (64 bytes)
+//   nEntries entries, one every stride rows: the byte offset of the
+//   row in data.log and the greatest timestamp of the rows before it
+// The size and the modification time of data.log are in the header,
+// an index that does not match them is built again.
+//---------------------------------------------------------
+#define DUMPER_LOG_INDEX_MAGIC "ICUBLIDX"
+#define DUMPER_LOG_INDEX_VERSION 1
+
+struct DumperLogIndexHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t stride;        // rows between two entries
+    uint64_t nEntries;
+    uint64_t nRows;
+    uint64_t dataSize;      // bytes of data.log when it was indexed
+    int64_t dataTime;       // and its modification time (s)
+    double firstTimestamp;
+    double lastTimestamp;   // the greatest one
+};
+
+struct DumperLogIndexEntry
+{
+    double before;          // greatest timestamp before offset, -inf for the first row
+    uint64_t offset;
+};
+
+class DumperLogIndex
+{
+public:
+    DumperLogIndex();
+
+    // the index of dataName from dataName.idx, built and written
+    // if it is missing or out of date (kept in memory only if it
+    // cannot be written)
+    bool open(const std::string &dataName, int stride=64);
+
+    int numberOfRows() const { return (int)header.nRows; }
+    double firstTimestamp() const { return header.firstTimestamp; }
+    double lastTimestamp() const { return header.lastTimestamp; }
+
+    // the rows from the returned entry on include all those with a
+    // timestamp >= start
+    const DumperLogIndexEntry &find(double start) const;
+
+    // the offset from which all the rows have a timestamp > end,
+    // or the size of data.log
+    uint64_t end(double end) const;
+
+private:
+    bool read(const std::string &indexName);
+    bool build(const std::string &dataName, int stride);
+    bool write(const std::string &indexName) const;
+
+    DumperLogIndexHeader header;
+    std::vector<DumperLogIndexEntry> entries;
+};
+
+#endif
@@ -0,0 +1,153 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#include "encoderReader.h"
+
+#include <math.h>
+#include <string.h>
+#include <iostream>
+#include <yarp/os/Time.h>
+
+using namespace yarp::os;
+using namespace yarp::dev;
+using namespace std;
+
+//---------------------------------------------------------
+// EncoderReader
+//---------------------------------------------------------
+EncoderReader::EncoderReader(IEncoders *encs[nBodyParts], int periodMs, PlayerClock &clock)
+    : RateThread(periodMs), clock(clock), sequence(0), failures(0)
+{
+    for(int p=0; p<nBodyParts; p++)
+        this->encs[p] = encs[p];
+    memset(&published, 0, sizeof(published));
+}
+
+bool EncoderReader::threadInit()
+{
+    for(int p=0; p<nBodyParts; p++)
+    {
+        int nj=0;
+        if(!encs[p]->getAxes(&nj) || nj<bodyPartSize[p])
+        {
+            cout<<"ERROR: "<<bodyPartNames[p]<<" has "<<nj<<" encoders, "<<bodyPartSize[p]<<" are played"<<endl;
+            return false;
+        }
+        all[p].resize(nj);
+    }
+    return true;
+}
+
+void EncoderReader::run()
+{
+    // all the parts first: the snapshot is not touched if one fails
+    for(int p=0; p<nBodyParts; p++)
+    {
+        if(!encs[p]->getEncoders(&all[p][0]))
+        {
+            failures++;
+            return;
+        }
+    }
+    double stamp = clock.now();
+
+    unsigned s = sequence.load(std::memory_order_relaxed);
+    sequence.store(s+1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for(int p=0; p<nBodyParts; p++)
+        memcpy(published.q+bodyPartOffset[p], &all[p][0], bodyPartSize[p]*sizeof(double));
+    published.stamp = stamp;
+    sequence.store(s+2, std::memory_order_release);
+}
+
+bool EncoderReader::poll()
+{
+    // the sizes are set by the first call, as by the thread
+    if(all[0].empty() && !threadInit())
+        return false;
+    int before = failures;
+    run();
+    return failures==before;
+}
+
+bool EncoderReader::latest(EncoderSnapshot &snapshot) const
+{
+    while(true)
+    {
+        unsigned s = sequence.load(std::memory_order_acquire);
+        if(s==0)
+            return false;
+        if(s&1)
+            continue;   // being written
+        memcpy(&snapshot, &published, sizeof(snapshot));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if(sequence.load(std::memory_order_relaxed)==s)
+            return true;
+    }
+}
+
+bool EncoderReader::waitFirst(double timeout) const
+{
+    double start=Time::now();
+    while(sequence.load(std::memory_order_acquire)==0)
+    {
+        if(Time::now()-start>timeout)
+            return false;
+        Time::delay(0.01);
+    }
+    return true;
+}
+
+//---------------------------------------------------------
+// TrackingMonitor
+//---------------------------------------------------------
+TrackingMonitor::TrackingMonitor() : lastWorst(0.0), samples(0)
+{
+    memset(sumSq, 0, sizeof(sumSq));
+    memset(maxAbs, 0, sizeof(maxAbs));
+}
+
+void TrackingMonitor::update(const double *command, const EncoderSnapshot &snapshot)
+{
+    lastWorst = 0.0;
+    for(int j=0; j<nBodyJoints; j++)
+    {
+        double e = fabs(command[j]-snapshot.q[j]);
+        sumSq[j] += e*e;
+        if(e>maxAbs[j])
+            maxAbs[j] = e;
+        if(e>lastWorst)
+            lastWorst = e;
+    }
+    samples++;
+}
+
+double TrackingMonitor::rms(int j) const
+{
+    return samples>0 ? sqrt(sumSq[j]/samples) : 0.0;
+}
+
+void printTrackingReport(const TrackingMonitor &tracking)
+{
+    cout<<"Tracking error over "<<tracking.numberOfSamples()<<" ticks (deg, rms / worst per joint):"<<endl;
+    for(int p=0; p<nBodyParts; p++)
+    {
+        cout<<"  "<<bodyPartNames[p]<<" :";
+        for(int j=0; j<bodyPartSize[p]; j++)
+            cout<<" "<<tracking.rms(bodyPartOffset[p]+j)<<"/"<<tracking.worst(bodyPartOffset[p]+j);
+        cout<<endl;
+    }
+}
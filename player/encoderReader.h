@@ -0,0 +1,101 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#ifndef ENCODER_READER_H
+#define ENCODER_READER_H
+
+#include <atomic>
+#include <vector>
+#include <yarp/dev/ControlBoardInterfaces.h>
+#include <yarp/os/RateThread.h>
+#include "wholeBodyTrajectory.h"
+#include "playerClock.h"
+
+//---------------------------------------------------------
+// the encoders of the played joints, in the layout of a frame
+//---------------------------------------------------------
+struct EncoderSnapshot
+{
+    alignas(64) double q[WholeBodyTrajectory::frameStride];
+    double stamp;       // Time::now() when it was read
+};
+
+//---------------------------------------------------------
+// reads the encoders of the parts in the background and publishes
+// the latest snapshot under a sequence lock: the parts are read
+// into all[] first, then copied into the snapshot between an odd and
+// an even count. The writer never waits, a reader copies the snapshot
+// again if the count was odd or changed while it was copying. With a
+// virtual clock there is no thread: the snapshots are taken by poll()
+// in the playing loop.
+//---------------------------------------------------------
+class EncoderReader : public yarp::os::RateThread
+{
+public:
+    EncoderReader(yarp::dev::IEncoders *encs[nBodyParts], int periodMs=5, PlayerClock &clock=systemClock());
+
+    // a snapshot now, in the calling thread (the reading thread must not run)
+    bool poll();
+
+    // false if there is no snapshot yet
+    bool latest(EncoderSnapshot &snapshot) const;
+
+    // wait for the first snapshot, false after timeout seconds
+    bool waitFirst(double timeout) const;
+
+    int numberOfReads() const { return (int)(sequence.load(std::memory_order_acquire)/2); }
+    int numberOfFailures() const { return failures; }
+
+protected:
+    virtual bool threadInit();
+    virtual void run();
+
+private:
+    yarp::dev::IEncoders *encs[nBodyParts];
+    std::vector<double> all[nBodyParts];    // all the joints of the board
+    PlayerClock &clock;                     // of the snapshot stamps
+
+    EncoderSnapshot published;
+    std::atomic<unsigned> sequence;         // odd while published is written, twice the snapshots otherwise
+    int failures;
+};
+
+//---------------------------------------------------------
+// tracking error of the played joints: command - encoders
+//---------------------------------------------------------
+class TrackingMonitor
+{
+public:
+    TrackingMonitor();
+
+    void update(const double *command, const EncoderSnapshot &snapshot);
+
+    int numberOfSamples() const { return samples; }
+    double rms(int j) const;
+    double worst(int j) const { return maxAbs[j]; }
+    double latestWorst() const { return lastWorst; }  // worst joint of the latest update
+
+private:
+    double sumSq[WholeBodyTrajectory::frameStride];
+    double maxAbs[WholeBodyTrajectory::frameStride];
+    double lastWorst;
+    int samples;
+};
+
+// one line per part: rms and worst error of its joints
+void printTrackingReport(const TrackingMonitor &tracking);
+
+#endif
@@ -0,0 +1,446 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#include "humanData.h"
+#include "mappedFile.h"
+#include "rigidBodyReader.h"
+#include "binaryTrajectory.h"
+
+#include <stdio.h>
+#include <ctype.h>
+#include <math.h>
+#include <string.h>
+#include <iostream>
+#include <yarp/os/Time.h>
+#include <yarp/sig/Matrix.h>
+
+using namespace yarp::os;
+using namespace yarp::sig;
+using namespace std;
+
+const char *humanJointNames[nHumanJoints] =
+{
+	"hip_pitch", "hip_roll", "knee", "ankle_pitch",
+	"shoulder_pitch", "shoulder_roll", "shoulder_yaw",
+	"elbow", "torso_pitch"
+};
+
+//---------------------------------------------------------
+// HumanData
+//---------------------------------------------------------
+HumanData::HumanData() : rate(0.0), step(1), nFrames(0)
+{
+	for(int k=0; k<nHumanJoints; k++)
+		column[k] = 0;
+}
+
+void HumanData::useJoints()
+{
+	mapping.close();
+	for(int k=0; k<nHumanJoints; k++)
+		column[k] = joint[k].data();
+	step = 1;
+	nFrames = (int)joint[0].size();
+}
+
+void HumanData::useMapping(const int mappedColumn[nHumanJoints], int step)
+{
+	for(int k=0; k<nHumanJoints; k++)
+	{
+		joint[k].clear();
+		column[k] = mapping.column(mappedColumn[k]);
+	}
+	this->step = step;
+	nFrames = (mapping.numberOfFrames()+step-1)/step;
+}
+
+// the values of a csv export are separated by one comma
+static void skipComma(const char *&p, const char *end)
+{
+	skipBlanks(p, end);
+	if (p<end && *p==',')
+		p++;
+}
+
+//---------------------------------------------------------
+// read the human joint angles from a text file (space or comma separated)
+// single pass on the memory mapped file, the vectors grow as rows are parsed
+//---------------------------------------------------------
+bool loadFileHumanData (const string &filename, HumanData &data)
+{
+	cout<<"Reading trajectories from file: "<<filename<<endl;
+	
+	// map the file
+	MappedFile inputFile;
+	if (!inputFile.open(filename))
+	{
+		cout << "ERROR: Can't open file: " << filename << endl;
+		return false;
+	}
+	
+	// Frame,0-HipPitch,1-HipRoll,3-Knee,4-AnklePitch,0-ShoulderPitch,1-ShoulderRoll,2-ShoulderYaw,3-Elbow,2-TorsoPitch
+	const int nColumns=nHumanJoints;
+	
+	// first guess of the capacity from the file size, doubled when exceeded
+	int capacity = inputFile.size()/64 + 16;
+	for(int k=0; k<nColumns; k++)
+		data.joint[k].resize(capacity);
+	
+	const char *p = inputFile.begin();
+	const char *end = inputFile.end();
+	double counterToIgnore;
+	double lastReport = Time::now();
+	int line=0;
+	int nbIter=0;
+	
+	while (p<end)
+	{
+		line++;
+		skipBlanks(p, end);
+		if (p==end || *p=='\n')
+		{
+			// empty line
+			skipLine(p, end);
+			continue;
+		}
+		if (line==1 && !isdigit(*p) && *p!='-' && *p!='+' && *p!='.')
+		{
+			// csv export, the first line has the column names
+			skipLine(p, end);
+			continue;
+		}
+		
+		if (nbIter==capacity)
+		{
+			capacity*=2;
+			for(int k=0; k<nColumns; k++)
+				data.joint[k].resize(capacity);
+		}
+		
+		bool ok = parseDouble(p, end, counterToIgnore);
+		for(int k=0; ok && k<nColumns; k++)
+		{
+			skipComma(p, end);
+			ok = parseDouble(p, end, data.joint[k][nbIter]);
+		}
+		if (!ok)
+		{
+			cout << endl << "ERROR: " << filename << " line " << line << " does not have "<< nColumns+1 << " numbers" << endl;
+			return false;
+		}
+		skipLine(p, end);
+		nbIter++;
+		
+		// progress, at most a few times per second
+		if ((nbIter & 1023)==0 && Time::now()-lastReport > 0.25)
+		{
+			lastReport = Time::now();
+			printf ("Load file %s : %d%%\r", filename.c_str (), (int)(100.0*(p-inputFile.begin())/inputFile.size()));
+			fflush(stdout);
+		}
+	}
+	
+	for(int k=0; k<nColumns; k++)
+		data.joint[k].resize(nbIter);
+	data.useJoints();
+	
+	cout << "INFO: "<< filename << " is a record of " << nbIter << " iterations" << endl;
+	cout<<"File is read! "<<endl;
+	return true;
+
+}
+
+//---------------------------------------------------------
+// joint angles from the rigid bodies of the motion capture
+// each joint is one ZYX euler angle (0=z, 1=y, 2=x) of the child segment
+// relative to its parent, or to the lab if there is no parent, times
+// gain plus offset. Gains and offsets are fitted on jointAngles_noheader.txt,
+// which is frames 365 to 617 of sit2stand-rigid.txt (see checkRigidBodyJoints);
+// the rms error is in the comments. A joint with gain 0 is not measured
+// by the capture and is held at its offset.
+//---------------------------------------------------------
+struct RigidBodyJoint
+{
+	const char *parent;
+	const char *child;
+	int axis;
+	double gain;
+	double offset;
+};
+
+static const RigidBodyJoint rigidBodyJoints[nHumanJoints] =
+{
+	{ "smart_low_back", "smart_thigh",   1, -1.0,   4.2 },	// hip_pitch       2.6 deg
+	{ 0,                "smart_thigh",   2, -1.0,   0.9 },	// hip_roll        2.5 deg
+	{ "smart_thigh",    "smart_shank",   1, -1.0,  -0.6 },	// knee            4.0 deg
+	{ "smart_shank",    "smart_foot",    1,  1.0, -20.9 },	// ankle_pitch     1.0 deg
+	{ "smart_up_back",  "smart_up_arm",  1,  1.0, -79.8 },	// shoulder_pitch  5.6 deg
+	{ 0,                0,               0,  0.0,  12.0 },	// shoulder_roll   constant in the reference
+	{ 0,                0,               0,  0.0,   0.0 },	// shoulder_yaw    no segment angle follows it
+	{ "smart_up_arm",   "smart_low_arm", 0,  1.0,  -4.3 },	// elbow           1.2 deg
+	{ 0,                "smart_low_back",1,  1.0,   6.4 }	// torso_pitch     4.8 deg
+};
+
+// rotation matrix of the Rz Ry Rx angles (deg) of a segment
+static void rigidBodyRotation(const double *rzyx, double R[3][3])
+{
+	const double d2r = M_PI/180.0;
+	double cz=cos(rzyx[0]*d2r), sz=sin(rzyx[0]*d2r);
+	double cy=cos(rzyx[1]*d2r), sy=sin(rzyx[1]*d2r);
+	double cx=cos(rzyx[2]*d2r), sx=sin(rzyx[2]*d2r);
+	
+	R[0][0]=cz*cy;	R[0][1]=cz*sy*sx-sz*cx;	R[0][2]=cz*sy*cx+sz*sx;
+	R[1][0]=sz*cy;	R[1][1]=sz*sy*sx+cz*cx;	R[1][2]=sz*sy*cx-cz*sx;
+	R[2][0]=-sy;	R[2][1]=cy*sx;			R[2][2]=cy*cx;
+}
+
+bool loadFileRigidBody (const string &filename, double rate, HumanData &data)
+{
+	cout<<"Reading rigid bodies from file: "<<filename<<endl;
+	
+	RigidBodyReader reader;
+	if (!reader.open(filename))
+		return false;
+	
+	const int nJoints=nHumanJoints;
+	
+	// columns of the Rz of parent and child, Ry and Rx follow
+	int parentColumn[nJoints], childColumn[nJoints];
+	for(int k=0; k<nJoints; k++)
+	{
+		// -1: the lab, or a joint that is not measured
+		parentColumn[k]=-1;
+		childColumn[k]=-1;
+		if(rigidBodyJoints[k].gain==0.0)
+			continue;
+		bool found=true;
+		if(rigidBodyJoints[k].parent)
+			found=(parentColumn[k]=reader.findColumn(rigidBodyJoints[k].parent, "Rz"))>=0 && parentColumn[k]+2<reader.numberOfColumns();
+		childColumn[k]=reader.findColumn(rigidBodyJoints[k].child, "Rz");
+		if(!found || childColumn[k]<0 || childColumn[k]+2>=reader.numberOfColumns())
+		{
+			cout<<"ERROR: "<<filename<<" has no rotation for "<<(rigidBodyJoints[k].parent ? rigidBodyJoints[k].parent : "the lab")
+				<<" or "<<rigidBodyJoints[k].child<<endl;
+			return false;
+		}
+	}
+	
+	// the capture is decimated to the playback rate, if given
+	int step = 1;
+	if(rate>0.0 && reader.frequency()>rate)
+		step = (int)(reader.frequency()/rate+0.5);
+	data.rate = reader.frequency()/step;
+	cout<<"INFO: capture at "<<reader.frequency()<<" Hz ("<<reader.units()<<"), keeping one frame every "<<step<<endl;
+	
+	int capacity = reader.numberOfFrames()/step + 1;
+	for(int k=0; k<nJoints; k++)
+		data.joint[k].resize(capacity);
+	
+	const int framesPerChunk=256;
+	Matrix chunk;
+	int n, frame=0;
+	int nbIter=0;
+	while ((n=reader.readFrames(chunk, framesPerChunk))>0)
+	{
+		for(int f=0; f<n; f++, frame++)
+		{
+			if(frame%step != 0)
+				continue;
+			
+			if (nbIter==capacity)
+			{
+				capacity*=2;
+				for(int k=0; k<nJoints; k++)
+					data.joint[k].resize(capacity);
+			}
+			
+			const double *row = chunk[f];
+			for(int k=0; k<nJoints; k++)
+			{
+				if(childColumn[k]<0)
+				{
+					data.joint[k][nbIter] = rigidBodyJoints[k].offset;
+					continue;
+				}
+				
+				double Rp[3][3], Rc[3][3], R[3][3];
+				rigidBodyRotation(row+childColumn[k], Rc);
+				if(parentColumn[k]<0)
+					memcpy(R, Rc, sizeof(R));
+				else
+				{
+					// R = Rp^T Rc
+					rigidBodyRotation(row+parentColumn[k], Rp);
+					for(int r=0; r<3; r++)
+						for(int c=0; c<3; c++)
+							R[r][c]=Rp[0][r]*Rc[0][c]+Rp[1][r]*Rc[1][c]+Rp[2][r]*Rc[2][c];
+				}
+				
+				double angle;
+				if(rigidBodyJoints[k].axis==0)
+					angle=atan2(R[1][0],R[0][0]);
+				else if(rigidBodyJoints[k].axis==1)
+					angle=asin(-R[2][0]);
+				else
+					angle=atan2(R[2][1],R[2][2]);
+				
+				// a lost marker holds the previous value
+				angle = rigidBodyJoints[k].gain*angle*180.0/M_PI + rigidBodyJoints[k].offset;
+				if(isnan(angle) && nbIter>0)
+					angle = data.joint[k][nbIter-1];
+				data.joint[k][nbIter] = angle;
+			}
+			nbIter++;
+		}
+	}
+	if (n<0)
+	{
+		cout<<"ERROR: while reading "<<filename<<endl;
+		return false;
+	}
+	
+	for(int k=0; k<nJoints; k++)
+	{
+		data.joint[k].resize(nbIter);
+		
+		// markers lost from the start take the first valid value
+		int first=0;
+		while(first<nbIter && isnan(data.joint[k][first]))
+			first++;
+		if(first==nbIter)
+		{
+			cout<<"ERROR: "<<filename<<" has no valid frame for "<<humanJointNames[k]<<endl;
+			return false;
+		}
+		for(int c=0; c<first; c++)
+			data.joint[k][c] = data.joint[k][first];
+	}
+	data.useJoints();
+	
+	cout << "INFO: "<< filename << " is a record of " << nbIter << " iterations" << endl;
+	cout<<"File is read! "<<endl;
+	return true;
+}
+
+//---------------------------------------------------------
+// compare the joints computed from a capture with joint angles of the
+// same motion at the same rate (jointAngles_noheader.txt is at the
+// 100 Hz of sit2stand-rigid.txt): the reference is searched in the
+// capture, then the rms error of every measured joint must be below
+// tolerance degrees
+//---------------------------------------------------------
+bool checkRigidBodyJoints (const HumanData &capture, const HumanData &reference, double tolerance)
+{
+	int n=reference.numberOfFrames();
+	if(n==0 || n>capture.numberOfFrames())
+	{
+		cout<<"ERROR: the reference has "<<n<<" frames, the capture "<<capture.numberOfFrames()<<endl;
+		return false;
+	}
+	
+	// the frame of the capture where the reference starts, on the measured joints
+	int shift=0;
+	double best=HUGE_VAL;
+	for(int s=0; s+n<=capture.numberOfFrames(); s++)
+	{
+		double sum=0.0;
+		for(int k=0; k<nHumanJoints && sum<best; k++)
+			for(int t=0; rigidBodyJoints[k].gain!=0.0 && t<n; t++)
+			{
+				double e=capture.value(k, s+t)-reference.value(k, t);
+				sum+=e*e;
+			}
+		if(sum<best)
+		{
+			best=sum;
+			shift=s;
+		}
+	}
+	
+	cout<<"The reference is frames "<<shift+1<<" to "<<shift+n<<" of the capture, rms error (deg):"<<endl;
+	bool ok=true;
+	for(int k=0; k<nHumanJoints; k++)
+	{
+		double sum=0.0;
+		for(int t=0; t<n; t++)
+		{
+			double e=capture.value(k, shift+t)-reference.value(k, t);
+			sum+=e*e;
+		}
+		double rms=sqrt(sum/n);
+		bool measured=rigidBodyJoints[k].gain!=0.0;
+		cout<<"  "<<humanJointNames[k]<<" : "<<rms;
+		if(!measured)
+			cout<<" (not measured, held at "<<rigidBodyJoints[k].offset<<")";
+		else if(rms>tolerance)
+		{
+			cout<<" ERROR: over "<<tolerance;
+			ok=false;
+		}
+		cout<<endl;
+	}
+	return ok;
+}
+
+//---------------------------------------------------------
+// read the human joint angles from a binary trajectory
+// the columns are found by name and read in place from the mapping,
+// which is kept by data: no parsing, no copy
+//---------------------------------------------------------
+bool loadFileBinaryHumanData (const string &filename, double rate, HumanData &data)
+{
+	cout<<"Mapping binary trajectory: "<<filename<<endl;
+	
+	BinaryTrajectory &trajectory = data.mapping;
+	if (!trajectory.open(filename))
+		return false;
+	
+	int mappedColumn[nHumanJoints];
+	for(int k=0; k<nHumanJoints; k++)
+	{
+		mappedColumn[k] = trajectory.findJoint(humanJointNames[k]);
+		if(mappedColumn[k]<0)
+		{
+			cout<<"ERROR: "<<filename<<" has no joint "<<humanJointNames[k]<<endl;
+			trajectory.close();
+			return false;
+		}
+	}
+	
+	int step = 1;
+	if(rate>0.0 && trajectory.rate()>rate)
+		step = (int)(trajectory.rate()/rate+0.5);
+	data.rate = trajectory.rate()/step;
+	data.useMapping(mappedColumn, step);
+	
+	cout << "INFO: "<< filename << " is a record of " << data.numberOfFrames() << " iterations at " << data.rate << " Hz" << endl;
+	return true;
+}
+
+//---------------------------------------------------------
+// read the human joint angles from any of the formats above
+//---------------------------------------------------------
+bool loadHumanData (const string &filename, double rate, HumanData &data)
+{
+	if(BinaryTrajectory::isBinaryTrajectoryFile(filename))
+		return loadFileBinaryHumanData(filename, rate, data);
+	if(RigidBodyReader::isRigidBodyFile(filename))
+		return loadFileRigidBody(filename, rate, data);
+	
+	// the text files have no rate, they are played as they are
+	data.rate = 0.0;
+	return loadFileHumanData(filename, data);
+}
@@ -0,0 +1,95 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#ifndef HUMAN_DATA_H
+#define HUMAN_DATA_H
+
+#include <string>
+#include <yarp/sig/Vector.h>
+
+#include "binaryTrajectory.h"
+
+//---------------------------------------------------------
+// the joints of the human data, in the column order of
+// jointAngles_noheader.txt and of the binary trajectories
+//---------------------------------------------------------
+enum HumanJoint
+{
+    HIP_PITCH=0,
+    HIP_ROLL,
+    KNEE,
+    ANKLE_PITCH,
+    SHOULDER_PITCH,
+    SHOULDER_ROLL,
+    SHOULDER_YAW,
+    ELBOW,
+    TORSO_PITCH,
+    nHumanJoints
+};
+extern const char *humanJointNames[nHumanJoints];
+
+//---------------------------------------------------------
+// the human trajectory: the text and capture files are parsed into
+// joint[], a binary trajectory stays mapped and its columns are read
+// in place (a decimated one every step values), nothing is copied
+//---------------------------------------------------------
+struct HumanData
+{
+    yarp::sig::Vector joint[nHumanJoints];  // one trajectory per joint, indexed by HumanJoint (parsed files)
+    double rate;                            // Hz, 0 for the text files which carry no rate
+    BinaryTrajectory mapping;               // the binary trajectory, joint[] is then empty
+
+    HumanData();
+
+    int numberOfFrames() const { return nFrames; }
+
+    // joint k at frame t, from joint[] or from the mapping
+    double value(int k, int t) const { return column[k][(size_t)t*step]; }
+
+    // read value() from joint[], once it is filled
+    void useJoints();
+
+    // read value() from the mapping, one value every step of each column
+    void useMapping(const int mappedColumn[nHumanJoints], int step);
+
+private:
+    // not copyable: column points into joint[] or into the mapping
+    HumanData(const HumanData &);
+    HumanData &operator=(const HumanData &);
+
+    const double *column[nHumanJoints];
+    int step;
+    int nFrames;
+};
+
+// text joint angles: "frame hip_pitch ... torso_pitch", space or comma separated
+bool loadFileHumanData (const std::string &filename, HumanData &data);
+
+// raw rigid bodies capture (sit2stand-rigid.txt), decimated to rate if rate>0
+bool loadFileRigidBody (const std::string &filename, double rate, HumanData &data);
+
+// rms error of the joints of a capture against reference joint angles
+// of the same motion at the same rate (jointAngles_noheader.txt), false
+// if a measured joint is over tolerance degrees
+bool checkRigidBodyJoints (const HumanData &capture, const HumanData &reference, double tolerance);
+
+// binary trajectory written by trajectoryConverter, decimated to rate if rate>0
+bool loadFileBinaryHumanData (const std::string &filename, double rate, HumanData &data);
+
+// any of the above, chosen from the content of the file
+bool loadHumanData (const std::string &filename, double rate, HumanData &data);
+
+#endif
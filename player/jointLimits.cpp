@@ -0,0 +1,208 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#include "jointLimits.h"
+
+#include <float.h>
+#include <iostream>
+#include <yarp/os/Bottle.h>
+#include <yarp/os/Property.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using namespace yarp::os;
+using namespace yarp::dev;
+using namespace std;
+
+static const int frameStride = WholeBodyTrajectory::frameStride;
+
+//---------------------------------------------------------
+// limits
+//---------------------------------------------------------
+void defaultJointLimits(JointLimits &limits)
+{
+    // { min, max } in degrees
+    static const double arm[7][2] =
+        { {-85, 6}, {15, 80}, {-15, 78}, {15, 85}, {-70, 60}, {-70, 0}, {-10, 30} };
+    static const double torso[3][2] =
+        { {-25, 25}, {-8, 8}, {-10, 20} };
+    static const double leg[6][2] =
+        { {-30, 85}, {0, 80}, {-70, 70}, {-99, 0}, {-30, 30}, {-20, 20} };
+    const double (*part[nBodyParts])[2] = { arm, arm, torso, leg, leg };
+
+    for(int j=0; j<frameStride; j++)
+    {
+        limits.min[j] = -DBL_MAX;
+        limits.max[j] = DBL_MAX;
+    }
+    for(int p=0; p<nBodyParts; p++)
+        for(int j=0; j<bodyPartSize[p]; j++)
+        {
+            limits.min[bodyPartOffset[p]+j] = part[p][j][0];
+            limits.max[bodyPartOffset[p]+j] = part[p][j][1];
+        }
+}
+
+bool loadJointLimits(const string &filename, JointLimits &limits)
+{
+    Property config;
+    if(!config.fromConfigFile(filename.c_str()))
+    {
+        cout<<"ERROR: Can't read the joint limits file: "<<filename<<endl;
+        return false;
+    }
+
+    for(int p=0; p<nBodyParts; p++)
+    {
+        Bottle &group = config.findGroup(bodyPartNames[p]);
+        if(group.isNull())
+            continue;
+
+        // "min v0 v1 ..." : the key then one value per joint
+        Bottle &min = group.findGroup("min");
+        Bottle &max = group.findGroup("max");
+        if(min.size()!=bodyPartSize[p]+1 || max.size()!=bodyPartSize[p]+1)
+        {
+            cout<<"ERROR: "<<filename<<": ["<<bodyPartNames[p]<<"] needs min and max with "<<bodyPartSize[p]<<" values"<<endl;
+            return false;
+        }
+        for(int j=0; j<bodyPartSize[p]; j++)
+        {
+            limits.min[bodyPartOffset[p]+j] = min.get(j+1).asDouble();
+            limits.max[bodyPartOffset[p]+j] = max.get(j+1).asDouble();
+            if(limits.min[bodyPartOffset[p]+j]>limits.max[bodyPartOffset[p]+j])
+            {
+                cout<<"ERROR: "<<filename<<": ["<<bodyPartNames[p]<<"] joint "<<j<<" has min > max"<<endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool readJointLimits(IControlLimits *ilim, BodyPart part, JointLimits &limits)
+{
+    if(!ilim)
+        return false;
+    for(int j=0; j<bodyPartSize[part]; j++)
+    {
+        double min, max;
+        if(!ilim->getLimits(j, &min, &max))
+        {
+            cout<<"ERROR: can't get the limits of "<<bodyPartNames[part]<<" joint "<<j<<endl;
+            return false;
+        }
+        limits.min[bodyPartOffset[part]+j] = min;
+        limits.max[bodyPartOffset[part]+j] = max;
+    }
+    return true;
+}
+
+//---------------------------------------------------------
+// one frame: excess[j] is how far joint j is outside its limits
+// (<=0 inside), the frame is saturated in place; true if any
+// joint is outside
+//---------------------------------------------------------
+static inline bool checkFrame(double *frame, const JointLimits &limits, double *excess)
+{
+#if defined(__SSE2__)
+    const __m128d zero = _mm_setzero_pd();
+    __m128d outside = zero;
+    for(int j=0; j<frameStride; j+=2)
+    {
+        __m128d q  = _mm_load_pd(frame+j);
+        __m128d lo = _mm_load_pd(limits.min+j);
+        __m128d hi = _mm_load_pd(limits.max+j);
+        __m128d e  = _mm_max_pd(_mm_sub_pd(q, hi), _mm_sub_pd(lo, q));
+        _mm_store_pd(excess+j, e);
+        outside = _mm_or_pd(outside, _mm_cmpgt_pd(e, zero));
+        _mm_store_pd(frame+j, _mm_min_pd(_mm_max_pd(q, lo), hi));
+    }
+    return _mm_movemask_pd(outside)!=0;
+#else
+    bool outside=false;
+    for(int j=0; j<frameStride; j++)
+    {
+        double q = frame[j];
+        double e = q-limits.max[j] > limits.min[j]-q ? q-limits.max[j] : limits.min[j]-q;
+        excess[j] = e;
+        outside = outside || e>0.0;
+        frame[j] = q<limits.min[j] ? limits.min[j] : (q>limits.max[j] ? limits.max[j] : q);
+    }
+    return outside;
+#endif
+}
+
+bool saturateFrame(double *frame, const JointLimits &limits)
+{
+    alignas(64) double excess[frameStride];
+    return checkFrame(frame, limits, excess);
+}
+
+//---------------------------------------------------------
+// whole trajectory
+//---------------------------------------------------------
+int checkJointLimits(WholeBodyTrajectory &traj, int first, const JointLimits &limits,
+                     JointLimitsReport &report)
+{
+    for(int j=0; j<nBodyJoints; j++)
+    {
+        report.joint[j].firstFrame = -1;
+        report.joint[j].count = 0;
+        report.joint[j].worstExcess = 0.0;
+    }
+    report.totalViolations = 0;
+    report.infeasibleFrames = 0;
+
+    alignas(64) double excess[frameStride];
+    for(int t=(first>0 ? first : 0); t<traj.numberOfFrames(); t++)
+    {
+        // most frames are inside the limits: only the others are looked at joint by joint
+        if(!checkFrame(traj.frame(t), limits, excess))
+            continue;
+
+        report.infeasibleFrames++;
+        for(int j=0; j<nBodyJoints; j++)
+        {
+            if(excess[j]<=0.0)
+                continue;
+            JointLimitsViolation &v = report.joint[j];
+            if(v.firstFrame<0)
+                v.firstFrame = t;
+            v.count++;
+            if(excess[j]>v.worstExcess)
+                v.worstExcess = excess[j];
+            report.totalViolations++;
+        }
+    }
+    return report.totalViolations;
+}
+
+void printJointLimitsReport(const JointLimitsReport &report)
+{
+    cout<<"Joint limits: "<<report.totalViolations<<" violations in "
+        <<report.infeasibleFrames<<" frames"<<endl;
+    for(int p=0; p<nBodyParts; p++)
+        for(int j=0; j<bodyPartSize[p]; j++)
+        {
+            const JointLimitsViolation &v = report.joint[bodyPartOffset[p]+j];
+            if(v.count==0)
+                continue;
+            cout<<"  "<<bodyPartNames[p]<<" "<<j<<": "<<v.count<<" frames from frame "<<v.firstFrame
+                <<", worst "<<v.worstExcess<<" deg beyond the limit"<<endl;
+        }
+}
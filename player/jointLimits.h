@@ -0,0 +1,82 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#ifndef JOINT_LIMITS_H
+#define JOINT_LIMITS_H
+
+#include <string>
+#include <yarp/dev/ControlBoardInterfaces.h>
+#include "wholeBodyTrajectory.h"
+
+//---------------------------------------------------------
+// joint limits in the layout of a frame, so that a frame is checked
+// with whole SIMD registers; the padding joints are unbounded.
+// The limits of part p are the bodyPartSize[p] values from
+// bodyPartOffset[p], all sizes are compile time constants.
+//---------------------------------------------------------
+struct JointLimits
+{
+    alignas(64) double min[WholeBodyTrajectory::frameStride];
+    alignas(64) double max[WholeBodyTrajectory::frameStride];
+
+    const double *partMin(BodyPart p) const { return min+bodyPartOffset[p]; }
+    const double *partMax(BodyPart p) const { return max+bodyPartOffset[p]; }
+};
+static_assert(nBodyJoints<=WholeBodyTrajectory::frameStride, "the joints of a frame do not fit in JointLimits");
+
+// the limits used on iCub for the sit-to-stand
+void defaultJointLimits(JointLimits &limits);
+
+// from a configuration file with one group per part ([right_arm],
+// [left_arm], [torso], [right_leg], [left_leg]), each with the lines
+// "min v0 v1 ..." and "max v0 v1 ..." in degrees; the parts that are
+// not in the file keep their limits
+bool loadJointLimits(const std::string &filename, JointLimits &limits);
+
+// from the control board of a part
+bool readJointLimits(yarp::dev::IControlLimits *ilim, BodyPart part, JointLimits &limits);
+
+//---------------------------------------------------------
+// violations of the limits over a trajectory, per joint of a frame
+//---------------------------------------------------------
+struct JointLimitsViolation
+{
+    int firstFrame;         // -1 if the joint is always inside its limits
+    int count;              // frames outside the limits
+    double worstExcess;     // degrees beyond the limit, 0 if none
+};
+
+struct JointLimitsReport
+{
+    JointLimitsViolation joint[nBodyJoints];
+    int totalViolations;    // sum of the counts
+    int infeasibleFrames;   // frames with at least one violation
+};
+
+// saturate one frame (aligned on 64 bytes) to the limits, true if a
+// joint was outside; the safety check of the playing loop
+bool saturateFrame(double *frame, const JointLimits &limits);
+
+// check the frames from first to the end against the limits in one pass,
+// and saturate the joints outside so that the trajectory can be played
+// as is; returns report.totalViolations
+int checkJointLimits(WholeBodyTrajectory &traj, int first, const JointLimits &limits,
+                     JointLimitsReport &report);
+
+// one line per joint that violates its limits
+void printJointLimitsReport(const JointLimitsReport &report);
+
+#endif
@@ -0,0 +1,89 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#ifndef JOINT_MAPPING_H
+#define JOINT_MAPPING_H
+
+#include "humanData.h"
+#include "wholeBodyTrajectory.h"
+
+//---------------------------------------------------------
+// retargeting of the human joints on the robot: each entry puts
+// gain*human+offset on one joint of one part. The joints that are
+// not in the table keep the encoders value. To play another joint
+// (e.g. the shoulder roll) just enable its line.
+//---------------------------------------------------------
+struct JointMapping
+{
+    HumanJoint source;
+    BodyPart part;
+    int joint;
+    double gain;
+    double offset;
+};
+
+constexpr JointMapping humanToRobot[] =
+{
+    // torso: "torso_yaw" "torso_roll" "torso_pitch"
+    { TORSO_PITCH,    TORSO,     2, 1.0, 0.0 },
+
+    // arms: "shoulder_pitch" "shoulder_roll" "shoulder_yaw" "elbow"
+    { SHOULDER_PITCH, RIGHT_ARM, 0, 1.0, 0.0 },
+    //{ SHOULDER_ROLL,  RIGHT_ARM, 1, 1.0, 0.0 },
+    //{ SHOULDER_YAW,   RIGHT_ARM, 2, 1.0, 0.0 },
+    { ELBOW,          RIGHT_ARM, 3, 1.0, 0.0 },
+    { SHOULDER_PITCH, LEFT_ARM,  0, 1.0, 0.0 },
+    //{ SHOULDER_ROLL,  LEFT_ARM,  1, 1.0, 0.0 },
+    //{ SHOULDER_YAW,   LEFT_ARM,  2, 1.0, 0.0 },
+    { ELBOW,          LEFT_ARM,  3, 1.0, 0.0 },
+
+    // legs: "hip_pitch" "hip_roll" "hip_yaw" "knee" "ankle_pitch" "ankle_roll"
+    { HIP_PITCH,      LEFT_LEG,  0, 1.0, 0.0 },
+    //{ HIP_ROLL,       LEFT_LEG,  1, 1.0, 0.0 },
+    { KNEE,           LEFT_LEG,  3, 1.0, 0.0 },
+    { ANKLE_PITCH,    LEFT_LEG,  4, 1.0, 0.0 },
+    { HIP_PITCH,      RIGHT_LEG, 0, 1.0, 0.0 },
+    //{ HIP_ROLL,       RIGHT_LEG, 1, 1.0, 0.0 },
+    { KNEE,           RIGHT_LEG, 3, 1.0, 0.0 },
+    { ANKLE_PITCH,    RIGHT_LEG, 4, 1.0, 0.0 }
+};
+
+constexpr int nJointMappings = sizeof(humanToRobot)/sizeof(humanToRobot[0]);
+
+// every entry must address a joint inside its part
+constexpr bool validJointMapping(int k)
+{
+    return k==nJointMappings ||
+           (humanToRobot[k].source>=0 && humanToRobot[k].source<nHumanJoints &&
+            humanToRobot[k].joint>=0 && humanToRobot[k].joint<bodyPartSize[humanToRobot[k].part] &&
+            validJointMapping(k+1));
+}
+static_assert(validJointMapping(0), "humanToRobot has a joint outside of its part");
+
+//---------------------------------------------------------
+// apply the table to frame t of the human data, on a whole-body
+// frame; the bounds are compile time constants so the loop is unrolled
+//---------------------------------------------------------
+inline void retargetFrame(const HumanData &human, int t, double *frame)
+{
+    for(int k=0; k<nJointMappings; k++)
+    {
+        const JointMapping &m = humanToRobot[k];
+        frame[bodyPartOffset[m.part]+m.joint] = m.gain*human.value(m.source, t) + m.offset;
+    }
+}
+
+#endif
@@ -0,0 +1,175 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+
+#include "latencyHistogram.h"
+
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <math.h>
+
+using namespace std;
+
+// values below 2*halfBucket are exact, then halfBucket buckets per power of two
+static const int subBucketBits = 7;
+static const int64_t halfBucket = 1<<(subBucketBits-1);
+
+//---------------------------------------------------------
+// LatencyHistogram
+//---------------------------------------------------------
+LatencyHistogram::LatencyHistogram(const string &name, double maxSeconds)
+    : histogramName(name), total(0), overflows(0), sum(0.0), maxValue(0)
+{
+    counts.assign(index((int64_t)(maxSeconds*1e9))+1, 0);
+}
+
+int LatencyHistogram::index(int64_t ns) const
+{
+    if(ns<2*halfBucket)
+        return ns<0 ? 0 : (int)ns;
+    // ns>>shift is in [halfBucket, 2*halfBucket)
+    int shift = (63-__builtin_clzll((unsigned long long)ns))-(subBucketBits-1);
+    return (int)(2*halfBucket+(shift-1)*halfBucket+((ns>>shift)-halfBucket));
+}
+
+int64_t LatencyHistogram::lowest(int k) const
+{
+    if(k<2*halfBucket)
+        return k;
+    int shift = (k-2*halfBucket)/halfBucket+1;
+    return ((k-2*halfBucket)%halfBucket+halfBucket)<<shift;
+}
+
+int64_t LatencyHistogram::highest(int k) const
+{
+    if(k<2*halfBucket)
+        return k;
+    int shift = (k-2*halfBucket)/halfBucket+1;
+    return (((k-2*halfBucket)%halfBucket+halfBucket+1)<<shift)-1;
+}
+
+void LatencyHistogram::record(double seconds)
+{
+    int64_t ns = seconds>0.0 ? (int64_t)(seconds*1e9+0.5) : 0;
+    int k = ns<(int64_t)1<<62 ? index(ns) : (int)counts.size();
+    if(k>=(int)counts.size())
+    {
+        k = (int)counts.size()-1;
+        overflows++;
+    }
+    counts[k]++;
+    total++;
+    sum += (double)ns;
+    if(ns>maxValue)
+        maxValue = ns;
+}
+
+void LatencyHistogram::reset()
+{
+    counts.assign(counts.size(), 0);
+    total = 0;
+    overflows = 0;
+    sum = 0.0;
+    maxValue = 0;
+}
+
+double LatencyHistogram::mean() const
+{
+    return total>0 ? sum/total*1e-9 : 0.0;
+}
+
+double LatencyHistogram::percentile(double percentile) const
+{
+    if(total==0)
+        return 0.0;
+    long rank = (long)ceil(percentile/100.0*total);
+    if(rank<1)
+        rank = 1;
+    long seen = 0;
+    for(int k=0; k<(int)counts.size(); k++)
+    {
+        seen += counts[k];
+        if(seen>=rank)
+            return (highest(k)<maxValue ? highest(k) : maxValue)*1e-9;
+    }
+    return maxValue*1e-9;
+}
+
+//---------------------------------------------------------
+// LoopTiming
+//---------------------------------------------------------
+LoopTiming::LoopTiming()
+    : period("period"), safety("safety"),
+      send{ LatencyHistogram(string("send ")+bodyPartNames[RIGHT_ARM]), LatencyHistogram(string("send ")+bodyPartNames[LEFT_ARM]),
+            LatencyHistogram(string("send ")+bodyPartNames[TORSO]), LatencyHistogram(string("send ")+bodyPartNames[RIGHT_LEG]),
+            LatencyHistogram(string("send ")+bodyPartNames[LEFT_LEG]) }
+{
+}
+
+static const double printedPercentiles[] = { 50.0, 90.0, 99.0, 99.9 };
+static const int nPrintedPercentiles = sizeof(printedPercentiles)/sizeof(printedPercentiles[0]);
+
+static void printHistogram(ostream &out, const LatencyHistogram &h)
+{
+    out<<"  "<<h.name()<<" : "<<h.numberOfValues()<<" "<<h.mean()*1000.0;
+    for(int k=0; k<nPrintedPercentiles; k++)
+        out<<" "<<h.percentile(printedPercentiles[k])*1000.0;
+    out<<" "<<h.max()*1000.0;
+    if(h.numberOfOverflows()>0)
+        out<<" ("<<h.numberOfOverflows()<<" beyond the histogram)";
+    out<<endl;
+}
+
+static void printLoopTiming(ostream &out, const LoopTiming &timing)
+{
+    out<<"Loop timing (ms: ticks mean p50 p90 p99 p99.9 max):"<<endl;
+    if(timing.period.numberOfValues()>0)
+        printHistogram(out, timing.period);
+    else
+        out<<"  period : not measured on a virtual clock"<<endl;
+    printHistogram(out, timing.safety);
+    for(int p=0; p<nBodyParts; p++)
+        printHistogram(out, timing.send[p]);
+}
+
+void printLoopTiming(const LoopTiming &timing)
+{
+    printLoopTiming(cout, timing);
+}
+
+bool writeLoopTiming(const string &filename, const LoopTiming &timing)
+{
+    ofstream out(filename.c_str());
+    if(!out)
+    {
+        cout<<"ERROR: Can't write the loop timing file: "<<filename<<endl;
+        return false;
+    }
+
+    printLoopTiming(out, timing);
+
+    // "name lowest highest count" in ns, for other percentiles or plots
+    const LatencyHistogram *all[2+nBodyParts] = { &timing.period, &timing.safety };
+    for(int p=0; p<nBodyParts; p++)
+        all[2+p] = &timing.send[p];
+    out<<"Buckets (ns: histogram lowest highest count):"<<endl;
+    for(int h=0; h<2+nBodyParts; h++)
+        for(int k=0; k<all[h]->numberOfBuckets(); k++)
+            if(all[h]->count(k)>0)
+                out<<"  "<<all[h]->name()<<" "<<all[h]->lowest(k)<<" "<<all[h]->highest(k)<<" "<<all[h]->count(k)<<endl;
+    return true;
+}
@@ -0,0 +1,92 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "wholeBodyTrajectory.h"
+
+//---------------------------------------------------------
+// histogram of durations in the style of HdrHistogram: the counts
+// are allocated by the constructor, then recording is a few integer
+// operations and never allocates. The values are in nanoseconds,
+// exact below 128 ns, then in buckets of 64 per power of two, so
+// that a value is known within 1.6% up to maxSeconds; the longer
+// ones are counted in the last bucket.
+//---------------------------------------------------------
+class LatencyHistogram
+{
+public:
+    LatencyHistogram(const std::string &name, double maxSeconds=60.0);
+
+    void record(double seconds);
+    void reset();
+
+    const std::string &name() const { return histogramName; }
+    long numberOfValues() const { return total; }
+    long numberOfOverflows() const { return overflows; }
+    double mean() const;                    // s
+    double max() const { return maxValue*1e-9; }
+
+    // the value (s) that percentile % of the values do not exceed,
+    // within the resolution of its bucket
+    double percentile(double percentile) const;
+
+    // the buckets, for an export: [lowest, highest] ns of the values
+    // counted in bucket k
+    int numberOfBuckets() const { return (int)counts.size(); }
+    long count(int k) const { return counts[k]; }
+    int64_t lowest(int k) const;
+    int64_t highest(int k) const;
+
+private:
+    int index(int64_t ns) const;
+
+    std::string histogramName;
+    std::vector<long> counts;
+    long total;
+    long overflows;
+    double sum;             // ns
+    int64_t maxValue;       // ns
+};
+
+//---------------------------------------------------------
+// the timing of the playing loop, one value per tick:
+//   period  |time between two ticks - their scheduled interval|
+//           (only with the system clock)
+//   safety  saturation of the command to the joint limits
+//   send    the call to the control board of each part
+//---------------------------------------------------------
+struct LoopTiming
+{
+    LoopTiming();
+
+    LatencyHistogram period;
+    LatencyHistogram safety;
+    LatencyHistogram send[nBodyParts];
+};
+
+// count, mean, percentiles 50 90 99 99.9 and max of every histogram, in ms
+void printLoopTiming(const LoopTiming &timing);
+
+// the same then the non empty buckets of every histogram, as text
+bool writeLoopTiming(const std::string &filename, const LoopTiming &timing);
+
+#endif
@@ -0,0 +1,206 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#include "mappedFile.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+//---------------------------------------------------------
+// MappedFile
+//---------------------------------------------------------
+MappedFile::MappedFile() : data(0), length(0)
+{
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const std::string &filename)
+{
+    close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if(fd<0)
+        return false;
+
+    struct stat st;
+    if(fstat(fd,&st)!=0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    // an empty file is valid, there is just nothing to map
+    if(st.st_size==0)
+    {
+        ::close(fd);
+        return true;
+    }
+
+    void *addr = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if(addr==MAP_FAILED)
+        return false;
+
+    // files are always read front to back
+    madvise(addr, st.st_size, MADV_SEQUENTIAL);
+
+    data = static_cast<const char *>(addr);
+    length = st.st_size;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if(data)
+        munmap(const_cast<char *>(data), length);
+    data = 0;
+    length = 0;
+}
+
+//---------------------------------------------------------
+// parsing
+//---------------------------------------------------------
+void skipBlanks(const char *&p, const char *end)
+{
+    while(p<end && (*p==' ' || *p=='\t' || *p=='\r'))
+        p++;
+}
+
+void skipLine(const char *&p, const char *end)
+{
+    const char *nl = static_cast<const char *>(memchr(p, '\n', end-p));
+    p = nl ? nl+1 : end;
+}
+
+static inline bool isDigit(char c)
+{
+    return c>='0' && c<='9';
+}
+
+static inline bool isSeparator(char c)
+{
+    return c==' ' || c=='\t' || c=='\r' || c=='\n' || c==',';
+}
+
+// slow path: nan, inf, or too many digits for an exact conversion
+static bool parseDoubleFallback(const char *&p, const char *end, double &value)
+{
+    char buffer[64];
+    size_t n=0;
+    while(p+n<end && !isSeparator(p[n]) && n<sizeof(buffer)-1)
+    {
+        buffer[n]=p[n];
+        n++;
+    }
+    buffer[n]='\0';
+
+    char *stop;
+    value = strtod(buffer, &stop);
+    if(stop==buffer)
+        return false;
+    p += stop-buffer;
+    return true;
+}
+
+bool parseDouble(const char *&p, const char *end, double &value)
+{
+    // powers of ten that are exact in a double
+    static const double pow10[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+    skipBlanks(p, end);
+    const char *start = p;
+    const char *q = p;
+
+    bool negative=false;
+    if(q<end && (*q=='-' || *q=='+'))
+    {
+        negative = (*q=='-');
+        q++;
+    }
+
+    unsigned long long mantissa=0;
+    int digits=0;       // significant digits in mantissa
+    int exponent=0;
+    bool any=false;
+
+    for(; q<end && isDigit(*q); q++)
+    {
+        any=true;
+        if(mantissa==0 && *q=='0')
+            continue;
+        mantissa = mantissa*10 + (*q-'0');
+        digits++;
+    }
+    if(q<end && *q=='.')
+    {
+        for(q++; q<end && isDigit(*q); q++)
+        {
+            any=true;
+            exponent--;
+            if(mantissa==0 && *q=='0')
+                continue;
+            mantissa = mantissa*10 + (*q-'0');
+            digits++;
+        }
+    }
+    if(!any)
+    {
+        p = start;
+        return parseDoubleFallback(p, end, value);
+    }
+
+    if(q<end && (*q=='e' || *q=='E'))
+    {
+        const char *e = q+1;
+        bool negexp=false;
+        if(e<end && (*e=='-' || *e=='+'))
+        {
+            negexp = (*e=='-');
+            e++;
+        }
+        if(e<end && isDigit(*e))
+        {
+            int x=0;
+            for(; e<end && isDigit(*e); e++)
+                if(x<10000) x = x*10 + (*e-'0');
+            exponent += negexp ? -x : x;
+            q = e;
+        }
+    }
+
+    // beyond 15 digits or 10^22 the division is no longer exactly rounded
+    if(digits>15 || exponent>22 || exponent<-22)
+    {
+        p = start;
+        return parseDoubleFallback(p, end, value);
+    }
+
+    double v = static_cast<double>(mantissa);
+    v = exponent<0 ? v/pow10[-exponent] : v*pow10[exponent];
+    value = negative ? -v : v;
+    p = q;
+    return true;
+}
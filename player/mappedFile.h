@@ -0,0 +1,61 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <stddef.h>
+#include <string>
+
+//---------------------------------------------------------
+// read-only memory map of a whole file
+//---------------------------------------------------------
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    bool open(const std::string &filename);
+    void close();
+
+    const char *begin() const { return data; }
+    const char *end() const { return data+length; }
+    size_t size() const { return length; }
+
+private:
+    // not copyable: the mapping is owned
+    MappedFile(const MappedFile &);
+    MappedFile &operator=(const MappedFile &);
+
+    const char *data;
+    size_t length;
+};
+
+//---------------------------------------------------------
+// in-place parsing of text numbers, bounded by end
+//---------------------------------------------------------
+
+// skip spaces, tabs and carriage returns, stopping at the end of the line
+void skipBlanks(const char *&p, const char *end);
+
+// move p just after the next '\n' (or to end)
+void skipLine(const char *&p, const char *end);
+
+// parse one number after optional blanks; on success p points after it
+bool parseDouble(const char *&p, const char *end, double &value);
+
+#endif
@@ -0,0 +1,819 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#include "mockControlBoard.h"
+
+#include <algorithm>
+#include <iostream>
+#include <mutex>
+#include <yarp/dev/Drivers.h>
+
+using namespace yarp::os;
+using namespace yarp::dev;
+using namespace std;
+
+// the joints of the remote control boards of the iCub
+static int defaultAxes(const string &remote)
+{
+    if(remote.find("arm")!=string::npos)
+        return 16;
+    if(remote.find("torso")!=string::npos)
+        return 3;
+    return 6;
+}
+
+MockControlBoard::MockControlBoard() : nj(0), clock(&systemClock()), nCommands(0)
+{
+}
+
+//---------------------------------------------------------
+// recording
+//---------------------------------------------------------
+void MockControlBoard::record(int j, int mode, double value)
+{
+    // the buffer is never resized: a full buffer only counts
+    long k = nCommands.fetch_add(1, std::memory_order_relaxed);
+    if(k<(long)commands.size())
+    {
+        MockCommand &c = commands[k];
+        c.time = clock->now();
+        c.joint = j;
+        c.mode = mode;
+        c.value = value;
+    }
+}
+
+int MockControlBoard::numberOfCommands() const
+{
+    long n = nCommands.load(std::memory_order_acquire);
+    return (int)(n<(long)commands.size() ? n : (long)commands.size());
+}
+
+long MockControlBoard::droppedCommands() const
+{
+    long n = nCommands.load(std::memory_order_acquire);
+    return n>(long)commands.size() ? n-(long)commands.size() : 0;
+}
+
+void MockControlBoard::clearCommands()
+{
+    nCommands.store(0, std::memory_order_release);
+}
+
+MockCommandReport MockControlBoard::commandReport() const
+{
+    MockCommandReport report;
+    report.commands = nCommands.load(std::memory_order_acquire);
+    report.dropped = droppedCommands();
+    report.sends = 0;
+    report.meanInterval = 0.0;
+    report.worstInterval = 0.0;
+
+    int n = numberOfCommands();
+    double start = 0.0;
+    double total = 0.0;
+    for(int k=0; k<n; k++)
+    {
+        if(k>0 && commands[k].joint>commands[k-1].joint)
+            continue;
+        if(report.sends>0)
+        {
+            double interval = commands[k].time-start;
+            total += interval;
+            report.worstInterval = max(report.worstInterval, interval);
+        }
+        start = commands[k].time;
+        report.sends++;
+    }
+    if(report.sends>1)
+        report.meanInterval = total/(report.sends-1);
+    return report;
+}
+
+//---------------------------------------------------------
+// DeviceDriver
+//---------------------------------------------------------
+bool MockControlBoard::open(Searchable &config)
+{
+    nj = config.check("axes") ? config.find("axes").asInt() : defaultAxes(config.find("remote").asString().c_str());
+    int capacity = config.check("capacity") ? config.find("capacity").asInt() : 4096;
+    if(nj<=0 || capacity<0)
+    {
+        cout<<"ERROR: mock_controlboard needs axes>0 and capacity>=0"<<endl;
+        return false;
+    }
+
+    q.assign(nj, config.check("home") ? config.find("home").asDouble() : 0.0);
+    references = q;
+    modes.assign(nj, VOCAB_CM_POSITION);
+    speeds.assign(nj, 10.0);
+    accelerations.assign(nj, 50.0);
+    stiffness.assign(nj, 0.0);
+    damping.assign(nj, 0.0);
+    offsets.assign(nj, 0.0);
+    refTorques.assign(nj, 0.0);
+    bemf.assign(nj, 0.0);
+    torqueErrorLimits.assign(nj, 0.0);
+    torquePids.assign(nj, Pid());
+    minLimits.assign(nj, -180.0);
+    maxLimits.assign(nj, 180.0);
+
+    commands.resize(capacity);
+    nCommands.store(0);
+    return true;
+}
+
+bool MockControlBoard::close()
+{
+    return true;
+}
+
+//---------------------------------------------------------
+// the joints are where they are commanded
+//---------------------------------------------------------
+void MockControlBoard::move(int j, int /*mode*/, double ref)
+{
+    references[j] = ref;
+    q[j] = ref;
+}
+
+void MockControlBoard::update()
+{
+}
+
+bool MockControlBoard::motionDone(int /*j*/)
+{
+    return true;
+}
+
+//---------------------------------------------------------
+// IPositionControl2
+//---------------------------------------------------------
+bool MockControlBoard::getAxes(int *ax)
+{
+    *ax = nj;
+    return true;
+}
+
+bool MockControlBoard::setPositionMode()
+{
+    lock_guard<Mutex> guard(mutex);
+    modes.assign(nj, VOCAB_CM_POSITION);
+    return true;
+}
+
+bool MockControlBoard::positionMove(int j, double ref)
+{
+    if(!valid(j))
+        return false;
+    record(j, VOCAB_CM_POSITION, ref);
+    lock_guard<Mutex> guard(mutex);
+    move(j, VOCAB_CM_POSITION, ref);
+    return true;
+}
+
+bool MockControlBoard::positionMove(const double *refs)
+{
+    for(int j=0; j<nj; j++)
+        record(j, VOCAB_CM_POSITION, refs[j]);
+    lock_guard<Mutex> guard(mutex);
+    for(int j=0; j<nj; j++)
+        move(j, VOCAB_CM_POSITION, refs[j]);
+    return true;
+}
+
+bool MockControlBoard::positionMove(const int n_joint, const int *joints, const double *refs)
+{
+    for(int k=0; k<n_joint; k++)
+        if(!valid(joints[k]))
+            return false;
+    for(int k=0; k<n_joint; k++)
+        record(joints[k], VOCAB_CM_POSITION, refs[k]);
+    lock_guard<Mutex> guard(mutex);
+    for(int k=0; k<n_joint; k++)
+        move(joints[k], VOCAB_CM_POSITION, refs[k]);
+    return true;
+}
+
+bool MockControlBoard::relativeMove(int j, double delta)
+{
+    if(!valid(j))
+        return false;
+    lock_guard<Mutex> guard(mutex);
+    record(j, VOCAB_CM_POSITION, references[j]+delta);
+    move(j, VOCAB_CM_POSITION, references[j]+delta);
+    return true;
+}
+
+bool MockControlBoard::relativeMove(const double *deltas)
+{
+    lock_guard<Mutex> guard(mutex);
+    for(int j=0; j<nj; j++)
+    {
+        record(j, VOCAB_CM_POSITION, references[j]+deltas[j]);
+        move(j, VOCAB_CM_POSITION, references[j]+deltas[j]);
+    }
+    return true;
+}
+
+bool MockControlBoard::checkMotionDone(int j, bool *flag)
+{
+    if(!valid(j))
+        return false;
+    lock_guard<Mutex> guard(mutex);
+    update();
+    *flag = motionDone(j);
+    return true;
+}
+
+bool MockControlBoard::checkMotionDone(bool *flag)
+{
+    lock_guard<Mutex> guard(mutex);
+    update();
+    *flag = true;
+    for(int j=0; j<nj; j++)
+        *flag = *flag && motionDone(j);
+    return true;
+}
+
+bool MockControlBoard::checkMotionDone(const int n_joint, const int *joints, bool *flag)
+{
+    for(int k=0; k<n_joint; k++)
+        if(!valid(joints[k]))
+            return false;
+    lock_guard<Mutex> guard(mutex);
+    update();
+    *flag = true;
+    for(int k=0; k<n_joint; k++)
+        *flag = *flag && motionDone(joints[k]);
+    return true;
+}
+
+bool MockControlBoard::setRefSpeed(int j, double sp)
+{
+    if(!valid(j))
+        return false;
+    speeds[j] = sp;
+    return true;
+}
+
+bool MockControlBoard::setRefSpeeds(const double *spds)
+{
+    for(int j=0; j<nj; j++)
+        speeds[j] = spds[j];
+    return true;
+}
+
+bool MockControlBoard::setRefSpeeds(const int n_joint, const int *joints, const double *spds)
+{
+    for(int k=0; k<n_joint; k++)
+        if(!setRefSpeed(joints[k], spds[k]))
+            return false;
+    return true;
+}
+
+bool MockControlBoard::setRefAcceleration(int j, double acc)
+{
+    if(!valid(j))
+        return false;
+    accelerations[j] = acc;
+    return true;
+}
+
+bool MockControlBoard::setRefAccelerations(const double *accs)
+{
+    for(int j=0; j<nj; j++)
+        accelerations[j] = accs[j];
+    return true;
+}
+
+bool MockControlBoard::getRefSpeed(int j, double *ref)
+{
+    if(!valid(j))
+        return false;
+    *ref = speeds[j];
+    return true;
+}
+
+bool MockControlBoard::getRefSpeeds(double *spds)
+{
+    for(int j=0; j<nj; j++)
+        spds[j] = speeds[j];
+    return true;
+}
+
+bool MockControlBoard::getRefAcceleration(int j, double *acc)
+{
+    if(!valid(j))
+        return false;
+    *acc = accelerations[j];
+    return true;
+}
+
+bool MockControlBoard::getRefAccelerations(double *accs)
+{
+    for(int j=0; j<nj; j++)
+        accs[j] = accelerations[j];
+    return true;
+}
+
+bool MockControlBoard::stop(int j)
+{
+    return valid(j);
+}
+
+bool MockControlBoard::stop()
+{
+    return true;
+}
+
+//---------------------------------------------------------
+// IPositionDirect
+//---------------------------------------------------------
+bool MockControlBoard::setPosition(int j, double ref)
+{
+    if(!valid(j))
+        return false;
+    record(j, VOCAB_CM_POSITION_DIRECT, ref);
+    lock_guard<Mutex> guard(mutex);
+    move(j, VOCAB_CM_POSITION_DIRECT, ref);
+    return true;
+}
+
+bool MockControlBoard::setPositions(const int n_joint, const int *joints, double *refs)
+{
+    for(int k=0; k<n_joint; k++)
+        if(!valid(joints[k]))
+            return false;
+    for(int k=0; k<n_joint; k++)
+        record(joints[k], VOCAB_CM_POSITION_DIRECT, refs[k]);
+    lock_guard<Mutex> guard(mutex);
+    for(int k=0; k<n_joint; k++)
+        move(joints[k], VOCAB_CM_POSITION_DIRECT, refs[k]);
+    return true;
+}
+
+bool MockControlBoard::setPositions(const double *refs)
+{
+    for(int j=0; j<nj; j++)
+        record(j, VOCAB_CM_POSITION_DIRECT, refs[j]);
+    lock_guard<Mutex> guard(mutex);
+    for(int j=0; j<nj; j++)
+        move(j, VOCAB_CM_POSITION_DIRECT, refs[j]);
+    return true;
+}
+
+//---------------------------------------------------------
+// IEncoders: the commanded positions
+//---------------------------------------------------------
+bool MockControlBoard::resetEncoder(int j)
+{
+    return setEncoder(j, 0.0);
+}
+
+bool MockControlBoard::resetEncoders()
+{
+    lock_guard<Mutex> guard(mutex);
+    q.assign(nj, 0.0);
+    references.assign(nj, 0.0);
+    return true;
+}
+
+bool MockControlBoard::setEncoder(int j, double val)
+{
+    if(!valid(j))
+        return false;
+    lock_guard<Mutex> guard(mutex);
+    q[j] = val;
+    references[j] = val;
+    return true;
+}
+
+bool MockControlBoard::setEncoders(const double *vals)
+{
+    lock_guard<Mutex> guard(mutex);
+    for(int j=0; j<nj; j++)
+        q[j] = references[j] = vals[j];
+    return true;
+}
+
+bool MockControlBoard::getEncoder(int j, double *v)
+{
+    if(!valid(j))
+        return false;
+    lock_guard<Mutex> guard(mutex);
+    update();
+    *v = q[j];
+    return true;
+}
+
+bool MockControlBoard::getEncoders(double *encs)
+{
+    lock_guard<Mutex> guard(mutex);
+    update();
+    for(int j=0; j<nj; j++)
+        encs[j] = q[j];
+    return true;
+}
+
+bool MockControlBoard::getEncoderSpeeds(double *spds)
+{
+    for(int j=0; j<nj; j++)
+        spds[j] = 0.0;
+    return true;
+}
+
+bool MockControlBoard::getEncoderSpeed(int j, double *sp)
+{
+    *sp = 0.0;
+    return valid(j);
+}
+
+bool MockControlBoard::getEncoderAccelerations(double *accs)
+{
+    for(int j=0; j<nj; j++)
+        accs[j] = 0.0;
+    return true;
+}
+
+bool MockControlBoard::getEncoderAcceleration(int j, double *acc)
+{
+    *acc = 0.0;
+    return valid(j);
+}
+
+//---------------------------------------------------------
+// IControlMode2: every mode is accepted
+//---------------------------------------------------------
+bool MockControlBoard::setPositionMode(int j)
+{
+    return setControlMode(j, VOCAB_CM_POSITION);
+}
+
+bool MockControlBoard::setVelocityMode(int j)
+{
+    return setControlMode(j, VOCAB_CM_VELOCITY);
+}
+
+bool MockControlBoard::setTorqueMode(int j)
+{
+    return setControlMode(j, VOCAB_CM_TORQUE);
+}
+
+bool MockControlBoard::setImpedancePositionMode(int j)
+{
+    return setControlMode(j, VOCAB_CM_IMPEDANCE_POS);
+}
+
+bool MockControlBoard::setImpedanceVelocityMode(int j)
+{
+    return setControlMode(j, VOCAB_CM_IMPEDANCE_VEL);
+}
+
+bool MockControlBoard::setOpenLoopMode(int j)
+{
+    return setControlMode(j, VOCAB_CM_OPENLOOP);
+}
+
+bool MockControlBoard::getControlMode(int j, int *mode)
+{
+    if(!valid(j))
+        return false;
+    lock_guard<Mutex> guard(mutex);
+    *mode = modes[j];
+    return true;
+}
+
+bool MockControlBoard::getControlModes(int *modes)
+{
+    lock_guard<Mutex> guard(mutex);
+    for(int j=0; j<nj; j++)
+        modes[j] = this->modes[j];
+    return true;
+}
+
+bool MockControlBoard::getControlModes(const int n_joint, const int *joints, int *modes)
+{
+    for(int k=0; k<n_joint; k++)
+        if(!getControlMode(joints[k], &modes[k]))
+            return false;
+    return true;
+}
+
+bool MockControlBoard::setControlMode(const int j, const int mode)
+{
+    if(!valid(j))
+        return false;
+    lock_guard<Mutex> guard(mutex);
+    modes[j] = mode;
+    return true;
+}
+
+bool MockControlBoard::setControlModes(const int n_joint, const int *joints, int *modes)
+{
+    for(int k=0; k<n_joint; k++)
+        if(!setControlMode(joints[k], modes[k]))
+            return false;
+    return true;
+}
+
+bool MockControlBoard::setControlModes(int *modes)
+{
+    lock_guard<Mutex> guard(mutex);
+    for(int j=0; j<nj; j++)
+        this->modes[j] = modes[j];
+    return true;
+}
+
+//---------------------------------------------------------
+// IImpedanceControl: stored, without effect
+//---------------------------------------------------------
+bool MockControlBoard::getImpedance(int j, double *stiffness, double *damping)
+{
+    if(!valid(j))
+        return false;
+    *stiffness = this->stiffness[j];
+    *damping = this->damping[j];
+    return true;
+}
+
+bool MockControlBoard::setImpedance(int j, double stiffness, double damping)
+{
+    if(!valid(j))
+        return false;
+    this->stiffness[j] = stiffness;
+    this->damping[j] = damping;
+    return true;
+}
+
+bool MockControlBoard::setImpedanceOffset(int j, double offset)
+{
+    if(!valid(j))
+        return false;
+    offsets[j] = offset;
+    return true;
+}
+
+bool MockControlBoard::getImpedanceOffset(int j, double *offset)
+{
+    if(!valid(j))
+        return false;
+    *offset = offsets[j];
+    return true;
+}
+
+bool MockControlBoard::getCurrentImpedanceLimit(int j, double *min_stiff, double *max_stiff, double *min_damp, double *max_damp)
+{
+    *min_stiff = 0.0;
+    *max_stiff = 1.0;
+    *min_damp = 0.0;
+    *max_damp = 0.1;
+    return valid(j);
+}
+
+//---------------------------------------------------------
+// ITorqueControl: stored, without effect, the measured torques are 0
+//---------------------------------------------------------
+bool MockControlBoard::setTorqueMode()
+{
+    lock_guard<Mutex> guard(mutex);
+    modes.assign(nj, VOCAB_CM_TORQUE);
+    return true;
+}
+
+bool MockControlBoard::getRefTorques(double *t)
+{
+    for(int j=0; j<nj; j++)
+        t[j] = refTorques[j];
+    return true;
+}
+
+bool MockControlBoard::getRefTorque(int j, double *t)
+{
+    if(!valid(j))
+        return false;
+    *t = refTorques[j];
+    return true;
+}
+
+bool MockControlBoard::setRefTorques(const double *t)
+{
+    for(int j=0; j<nj; j++)
+        refTorques[j] = t[j];
+    return true;
+}
+
+bool MockControlBoard::setRefTorque(int j, double t)
+{
+    if(!valid(j))
+        return false;
+    refTorques[j] = t;
+    return true;
+}
+
+bool MockControlBoard::getBemfParam(int j, double *bemf)
+{
+    if(!valid(j))
+        return false;
+    *bemf = this->bemf[j];
+    return true;
+}
+
+bool MockControlBoard::setBemfParam(int j, double bemf)
+{
+    if(!valid(j))
+        return false;
+    this->bemf[j] = bemf;
+    return true;
+}
+
+bool MockControlBoard::setTorquePid(int j, const Pid &pid)
+{
+    if(!valid(j))
+        return false;
+    torquePids[j] = pid;
+    return true;
+}
+
+bool MockControlBoard::getTorque(int j, double *t)
+{
+    *t = 0.0;
+    return valid(j);
+}
+
+bool MockControlBoard::getTorques(double *t)
+{
+    for(int j=0; j<nj; j++)
+        t[j] = 0.0;
+    return true;
+}
+
+bool MockControlBoard::getTorqueRange(int j, double *min, double *max)
+{
+    *min = -50.0;
+    *max = 50.0;
+    return valid(j);
+}
+
+bool MockControlBoard::getTorqueRanges(double *min, double *max)
+{
+    for(int j=0; j<nj; j++)
+        getTorqueRange(j, min+j, max+j);
+    return true;
+}
+
+bool MockControlBoard::setTorquePids(const Pid *pids)
+{
+    for(int j=0; j<nj; j++)
+        torquePids[j] = pids[j];
+    return true;
+}
+
+bool MockControlBoard::setTorqueErrorLimit(int j, double limit)
+{
+    if(!valid(j))
+        return false;
+    torqueErrorLimits[j] = limit;
+    return true;
+}
+
+bool MockControlBoard::setTorqueErrorLimits(const double *limits)
+{
+    for(int j=0; j<nj; j++)
+        torqueErrorLimits[j] = limits[j];
+    return true;
+}
+
+bool MockControlBoard::getTorqueError(int j, double *err)
+{
+    if(!valid(j))
+        return false;
+    *err = refTorques[j];
+    return true;
+}
+
+bool MockControlBoard::getTorqueErrors(double *errs)
+{
+    return getRefTorques(errs);
+}
+
+bool MockControlBoard::getTorquePidOutput(int j, double *out)
+{
+    *out = 0.0;
+    return valid(j);
+}
+
+bool MockControlBoard::getTorquePidOutputs(double *outs)
+{
+    for(int j=0; j<nj; j++)
+        outs[j] = 0.0;
+    return true;
+}
+
+bool MockControlBoard::getTorquePid(int j, Pid *pid)
+{
+    if(!valid(j))
+        return false;
+    *pid = torquePids[j];
+    return true;
+}
+
+bool MockControlBoard::getTorquePids(Pid *pids)
+{
+    for(int j=0; j<nj; j++)
+        pids[j] = torquePids[j];
+    return true;
+}
+
+bool MockControlBoard::getTorqueErrorLimit(int j, double *limit)
+{
+    if(!valid(j))
+        return false;
+    *limit = torqueErrorLimits[j];
+    return true;
+}
+
+bool MockControlBoard::getTorqueErrorLimits(double *limits)
+{
+    for(int j=0; j<nj; j++)
+        limits[j] = torqueErrorLimits[j];
+    return true;
+}
+
+bool MockControlBoard::resetTorquePid(int j)
+{
+    return valid(j);
+}
+
+bool MockControlBoard::disableTorquePid(int j)
+{
+    return valid(j);
+}
+
+bool MockControlBoard::enableTorquePid(int j)
+{
+    return valid(j);
+}
+
+bool MockControlBoard::setTorqueOffset(int j, double /*v*/)
+{
+    return valid(j);
+}
+
+//---------------------------------------------------------
+// IControlLimits
+//---------------------------------------------------------
+bool MockControlBoard::setLimits(int j, double min, double max)
+{
+    if(!valid(j))
+        return false;
+    minLimits[j] = min;
+    maxLimits[j] = max;
+    return true;
+}
+
+bool MockControlBoard::getLimits(int j, double *min, double *max)
+{
+    if(!valid(j))
+        return false;
+    *min = minLimits[j];
+    *max = maxLimits[j];
+    return true;
+}
+
+bool MockControlBoard::setVelLimits(int j, double /*min*/, double /*max*/)
+{
+    return valid(j);
+}
+
+bool MockControlBoard::getVelLimits(int j, double *min, double *max)
+{
+    *min = 0.0;
+    *max = 100.0;
+    return valid(j);
+}
+
+//---------------------------------------------------------
+// registration
+//---------------------------------------------------------
+void registerMockControlBoard()
+{
+    static std::once_flag registered;
+    std::call_once(registered, []()
+    {
+        Drivers::factory().add(new DriverCreatorOf<MockControlBoard>("mock_controlboard", "controlboardwrapper2", "MockControlBoard"));
+    });
+}
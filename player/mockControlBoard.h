@@ -0,0 +1,221 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#ifndef MOCK_CONTROL_BOARD_H
+#define MOCK_CONTROL_BOARD_H
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <yarp/os/Mutex.h>
+#include <yarp/dev/DeviceDriver.h>
+#include <yarp/dev/ControlBoardInterfaces.h>
+#include <yarp/dev/IPositionDirect.h>
+#include "playerClock.h"
+
+//---------------------------------------------------------
+// one command received by the mock board
+//---------------------------------------------------------
+struct MockCommand
+{
+    double time;        // now() of the clock of the board at the call
+    int joint;
+    int mode;           // VOCAB_CM_POSITION (positionMove) or VOCAB_CM_POSITION_DIRECT (setPosition)
+    double value;
+};
+
+// the recorded commands of a board summed up: a send is a sweep over
+// the joints (a joint not greater than the previous one starts the next)
+struct MockCommandReport
+{
+    long commands;          // received, recorded or not
+    long dropped;           // not recorded, the buffer was full
+    int sends;              // among the recorded commands
+    double meanInterval;    // s, between the starts of two sends
+    double worstInterval;
+};
+
+//---------------------------------------------------------
+// in-process stand-in for a remote_controlboard, device
+// "mock_controlboard": the joints are where they are commanded, and
+// every position command is recorded in a buffer allocated at open
+//   axes      joints (default: from the part in "remote", as the iCub)
+//   capacity  commands recorded, one per joint of a call; the next ones
+//             are only counted (default 4096, the player sets the ticks
+//             of its trajectory times the joints of the part, and clears
+//             them when it starts playing)
+//   home      initial positions (default 0)
+// The torques are stored and read back as references, they have no
+// effect: the measured torques are 0.
+//---------------------------------------------------------
+class MockControlBoard : public yarp::dev::DeviceDriver,
+                         public yarp::dev::IPositionControl2,
+                         public yarp::dev::IPositionDirect,
+                         public yarp::dev::IEncoders,
+                         public yarp::dev::IControlMode2,
+                         public yarp::dev::IImpedanceControl,
+                         public yarp::dev::ITorqueControl,
+                         public yarp::dev::IControlLimits
+{
+public:
+    MockControlBoard();
+
+    // the recorded commands, in the order they were received
+    int numberOfCommands() const;
+    const MockCommand &command(int k) const { return commands[k]; }
+    // commands not recorded because the buffer was full
+    long droppedCommands() const;
+    void clearCommands();
+    MockCommandReport commandReport() const;
+
+    // of the command stamps, the system time by default
+    virtual void setClock(PlayerClock &clock) { this->clock = &clock; }
+
+    // DeviceDriver
+    virtual bool open(yarp::os::Searchable &config);
+    virtual bool close();
+
+    // IPositionControl2
+    virtual bool getAxes(int *ax);
+    virtual bool setPositionMode();
+    virtual bool positionMove(int j, double ref);
+    virtual bool positionMove(const double *refs);
+    virtual bool positionMove(const int n_joint, const int *joints, const double *refs);
+    virtual bool relativeMove(int j, double delta);
+    virtual bool relativeMove(const double *deltas);
+    virtual bool checkMotionDone(int j, bool *flag);
+    virtual bool checkMotionDone(bool *flag);
+    virtual bool checkMotionDone(const int n_joint, const int *joints, bool *flag);
+    virtual bool setRefSpeed(int j, double sp);
+    virtual bool setRefSpeeds(const double *spds);
+    virtual bool setRefSpeeds(const int n_joint, const int *joints, const double *spds);
+    virtual bool setRefAcceleration(int j, double acc);
+    virtual bool setRefAccelerations(const double *accs);
+    virtual bool getRefSpeed(int j, double *ref);
+    virtual bool getRefSpeeds(double *spds);
+    virtual bool getRefAcceleration(int j, double *acc);
+    virtual bool getRefAccelerations(double *accs);
+    virtual bool stop(int j);
+    virtual bool stop();
+
+    // IPositionDirect
+    virtual bool setPosition(int j, double ref);
+    virtual bool setPositions(const int n_joint, const int *joints, double *refs);
+    virtual bool setPositions(const double *refs);
+
+    // IEncoders
+    virtual bool resetEncoder(int j);
+    virtual bool resetEncoders();
+    virtual bool setEncoder(int j, double val);
+    virtual bool setEncoders(const double *vals);
+    virtual bool getEncoder(int j, double *v);
+    virtual bool getEncoders(double *encs);
+    virtual bool getEncoderSpeeds(double *spds);
+    virtual bool getEncoderSpeed(int j, double *sp);
+    virtual bool getEncoderAccelerations(double *accs);
+    virtual bool getEncoderAcceleration(int j, double *acc);
+
+    // IControlMode2
+    virtual bool setPositionMode(int j);
+    virtual bool setVelocityMode(int j);
+    virtual bool setTorqueMode(int j);
+    virtual bool setImpedancePositionMode(int j);
+    virtual bool setImpedanceVelocityMode(int j);
+    virtual bool setOpenLoopMode(int j);
+    virtual bool getControlMode(int j, int *mode);
+    virtual bool getControlModes(int *modes);
+    virtual bool getControlModes(const int n_joint, const int *joints, int *modes);
+    virtual bool setControlMode(const int j, const int mode);
+    virtual bool setControlModes(const int n_joint, const int *joints, int *modes);
+    virtual bool setControlModes(int *modes);
+
+    // IImpedanceControl
+    virtual bool getImpedance(int j, double *stiffness, double *damping);
+    virtual bool setImpedance(int j, double stiffness, double damping);
+    virtual bool setImpedanceOffset(int j, double offset);
+    virtual bool getImpedanceOffset(int j, double *offset);
+    virtual bool getCurrentImpedanceLimit(int j, double *min_stiff, double *max_stiff, double *min_damp, double *max_damp);
+
+    // ITorqueControl
+    virtual bool setTorqueMode();
+    virtual bool getRefTorques(double *t);
+    virtual bool getRefTorque(int j, double *t);
+    virtual bool setRefTorques(const double *t);
+    virtual bool setRefTorque(int j, double t);
+    virtual bool getBemfParam(int j, double *bemf);
+    virtual bool setBemfParam(int j, double bemf);
+    virtual bool setTorquePid(int j, const yarp::dev::Pid &pid);
+    virtual bool getTorque(int j, double *t);
+    virtual bool getTorques(double *t);
+    virtual bool getTorqueRange(int j, double *min, double *max);
+    virtual bool getTorqueRanges(double *min, double *max);
+    virtual bool setTorquePids(const yarp::dev::Pid *pids);
+    virtual bool setTorqueErrorLimit(int j, double limit);
+    virtual bool setTorqueErrorLimits(const double *limits);
+    virtual bool getTorqueError(int j, double *err);
+    virtual bool getTorqueErrors(double *errs);
+    virtual bool getTorquePidOutput(int j, double *out);
+    virtual bool getTorquePidOutputs(double *outs);
+    virtual bool getTorquePid(int j, yarp::dev::Pid *pid);
+    virtual bool getTorquePids(yarp::dev::Pid *pids);
+    virtual bool getTorqueErrorLimit(int j, double *limit);
+    virtual bool getTorqueErrorLimits(double *limits);
+    virtual bool resetTorquePid(int j);
+    virtual bool disableTorquePid(int j);
+    virtual bool enableTorquePid(int j);
+    virtual bool setTorqueOffset(int j, double v);
+
+    // IControlLimits
+    virtual bool setLimits(int j, double min, double max);
+    virtual bool getLimits(int j, double *min, double *max);
+    virtual bool setVelLimits(int j, double min, double max);
+    virtual bool getVelLimits(int j, double *min, double *max);
+
+protected:
+    // the mutex is held: a position command to joint j, then the
+    // joints brought to clock->now() before they are read, and the
+    // end of a movement; the mock moves at once
+    virtual void move(int j, int mode, double ref);
+    virtual void update();
+    virtual bool motionDone(int j);
+
+    bool valid(int j) const { return j>=0 && j<nj; }
+
+    int nj;
+    PlayerClock *clock;
+    yarp::os::Mutex mutex;              // the state is shared by the senders and the encoders readers
+    std::vector<double> q;              // the encoders
+    std::vector<double> references;     // the last command of every joint
+    std::vector<double> speeds;         // positionMove reference speeds
+
+private:
+    void record(int j, int mode, double value);
+
+    std::vector<int> modes;
+    std::vector<double> accelerations;
+    std::vector<double> stiffness, damping, offsets;
+    std::vector<double> refTorques, bemf, torqueErrorLimits;
+    std::vector<yarp::dev::Pid> torquePids;
+    std::vector<double> minLimits, maxLimits;
+
+    std::vector<MockCommand> commands;  // capacity elements, never reallocated
+    std::atomic<long> nCommands;        // received, recorded or not
+};
+
+// make "mock_controlboard" known to PolyDriver (once per process)
+void registerMockControlBoard();
+
+#endif
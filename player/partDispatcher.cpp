@@ -0,0 +1,163 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#include "partDispatcher.h"
+
+#include <yarp/os/Thread.h>
+#include "playerClock.h"
+
+using namespace yarp::os;
+using namespace yarp::dev;
+
+void sendPart(PlayerPart &part, BodyPart p, const double *frame, bool directMode)
+{
+    const double *q = frame+bodyPartOffset[p];
+    AllocationAllowedScope device;
+    if(!directMode)
+        part.pos->positionMove(bodyPartSize[p], bodyPartJoints, q);
+    else if(part.allDirect)
+        part.posd->setPositions(bodyPartSize[p], bodyPartJoints, const_cast<double *>(q));
+    else
+    {
+        for(int j=0; j<bodyPartSize[p]; j++)
+        {
+            if(part.direct[j]) part.posd->setPosition(j, q[j]);
+            else part.pos->positionMove(j, q[j]);
+        }
+    }
+}
+
+//---------------------------------------------------------
+// the thread of a part: waits for a frame, sends it, signals done
+//---------------------------------------------------------
+class PartSender : public Thread
+{
+public:
+    PartSender(PlayerPart &part, BodyPart p, bool directMode, const RealTimeOptions &realTime,
+               Semaphore &done, double &sentAt, double &sendTime)
+        : part(part), p(p), directMode(directMode), realTime(realTime),
+          done(done), sentAt(sentAt), sendTime(sendTime), go(0), frame(0) {}
+
+    void dispatch(const double *f)
+    {
+        frame = f;
+        go.post();
+    }
+
+    virtual bool threadInit()
+    {
+        if(realTime.enabled)
+            makeThreadRealTime(realTime.priority, realTime.cpus);
+        return true;
+    }
+
+    virtual void run()
+    {
+        NoAllocationScope loop;
+        while(true)
+        {
+            go.wait();
+            if(isStopping())
+                return;
+            double start = monotonicTime();
+            sendPart(part, p, frame, directMode);
+            sentAt = monotonicTime();
+            sendTime = sentAt-start;
+            done.post();
+        }
+    }
+
+    virtual void onStop()
+    {
+        go.post();
+    }
+
+private:
+    PlayerPart &part;
+    BodyPart p;
+    bool directMode;
+    RealTimeOptions realTime;
+    Semaphore &done;
+    double &sentAt;
+    double &sendTime;
+    Semaphore go;
+    const double *frame;
+};
+
+//---------------------------------------------------------
+// PartDispatcher
+//---------------------------------------------------------
+PartDispatcher::PartDispatcher(PlayerPart parts[nBodyParts], bool directMode, bool concurrent,
+                               const RealTimeOptions &realTime)
+    : parts(parts), directMode(directMode), concurrent(concurrent), done(0),
+      nFrames(0), sumSkew(0.0), maxSkew(0.0)
+{
+    for(int p=0; p<nBodyParts; p++)
+    {
+        senders[p] = 0;
+        sentAt[p] = 0.0;
+        sendTime[p] = 0.0;
+        if(concurrent)
+        {
+            senders[p] = new PartSender(parts[p], (BodyPart)p, directMode, realTime, done, sentAt[p], sendTime[p]);
+            senders[p]->start();
+        }
+    }
+}
+
+PartDispatcher::~PartDispatcher()
+{
+    for(int p=0; p<nBodyParts; p++)
+    {
+        if(senders[p])
+        {
+            senders[p]->stop();
+            delete senders[p];
+        }
+    }
+}
+
+void PartDispatcher::send(const double *frame)
+{
+    if(concurrent)
+    {
+        for(int p=0; p<nBodyParts; p++)
+            senders[p]->dispatch(frame);
+        for(int p=0; p<nBodyParts; p++)
+            done.wait();
+    }
+    else
+    {
+        for(int p=0; p<nBodyParts; p++)
+        {
+            double start = monotonicTime();
+            sendPart(parts[p], (BodyPart)p, frame, directMode);
+            sentAt[p] = monotonicTime();
+            sendTime[p] = sentAt[p]-start;
+        }
+    }
+
+    double first=sentAt[0], last=sentAt[0];
+    for(int p=1; p<nBodyParts; p++)
+    {
+        if(sentAt[p]<first) first = sentAt[p];
+        if(sentAt[p]>last) last = sentAt[p];
+    }
+    nFrames++;
+    sumSkew += last-first;
+    if(last-first>maxSkew)
+        maxSkew = last-first;
+}
@@ -0,0 +1,85 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#ifndef PART_DISPATCHER_H
+#define PART_DISPATCHER_H
+
+#include <vector>
+#include <yarp/dev/ControlBoardInterfaces.h>
+#include <yarp/dev/IPositionDirect.h>
+#include <yarp/os/Semaphore.h>
+#include "wholeBodyTrajectory.h"
+#include "realTime.h"
+
+//---------------------------------------------------------
+// a played part: positionMove, or streaming in direct mode with
+// a per joint fallback to position
+//---------------------------------------------------------
+struct PlayerPart
+{
+    yarp::dev::IPositionControl2 *pos;
+    yarp::dev::IPositionDirect *posd;
+    yarp::dev::IControlMode2 *ictrl;
+    std::vector<bool> direct;   // joints of the frame in direct mode
+    bool allDirect;
+};
+
+// send part p of a whole-body frame
+void sendPart(PlayerPart &part, BodyPart p, const double *frame, bool directMode);
+
+class PartSender;
+
+//---------------------------------------------------------
+// sends whole-body frames to the control boards of the parts,
+// one thread per part so that they all get the frame at the same
+// time (or one after the other if not concurrent). The skew of a
+// frame is the time between the first and the last part sent.
+// With realTime.enabled the threads of the parts are real-time too.
+//---------------------------------------------------------
+class PartDispatcher
+{
+public:
+    PartDispatcher(PlayerPart parts[nBodyParts], bool directMode, bool concurrent=true,
+                   const RealTimeOptions &realTime=RealTimeOptions());
+    ~PartDispatcher();
+
+    // returns when every part has been sent
+    void send(const double *frame);
+
+    int numberOfFrames() const { return nFrames; }
+    double worstSkew() const { return maxSkew; }
+    double meanSkew() const { return nFrames>0 ? sumSkew/nFrames : 0.0; }
+    // seconds in the call to the control board of part p, latest frame
+    double sendDuration(BodyPart p) const { return sendTime[p]; }
+
+private:
+    PartDispatcher(const PartDispatcher &);
+    PartDispatcher &operator=(const PartDispatcher &);
+
+    PlayerPart *parts;
+    bool directMode;
+    bool concurrent;
+    PartSender *senders[nBodyParts];
+    yarp::os::Semaphore done;
+    double sentAt[nBodyParts];      // monotonic, like the send times
+    double sendTime[nBodyParts];
+
+    int nFrames;
+    double sumSkew;
+    double maxSkew;
+};
+
+#endif
@@ -0,0 +1,256 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#include "partDrivers.h"
+
+#include <stdio.h>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <yarp/os/Mutex.h>
+#include <yarp/os/Semaphore.h>
+#include <yarp/os/Time.h>
+
+using namespace yarp::os;
+using namespace yarp::dev;
+using namespace yarp::sig;
+using namespace std;
+
+//---------------------------------------------------------
+// open drivers with compliance (real robot)
+//---------------------------------------------------------
+bool openDriversArm(Property &options, string robot, string part, PolyDriver *&pd, IPositionControl2 *&ipos, IPositionDirect *&iposd, IEncoders *&ienc, IControlMode2 *&imode, IImpedanceControl *&iimp, ITorqueControl *&itrq)
+{
+    // open the device drivers
+    if(!options.check("device"))
+        options.put("device","remote_controlboard");
+    if(!options.check("local"))
+        options.put("local",string("/upperBodyPlayer/"+part).c_str());
+    options.put("remote",string("/"+robot+"/"+part).c_str());
+
+    if(!pd->open(options))
+    {
+        cout<<"Problems connecting to the remote driver of "<<part<<endl;
+        return false;
+    }
+    if(!pd->isValid())
+    {
+        printf("Device not available.  Here are the known devices:\n");
+        printf("%s", Drivers::factory().toString().c_str());
+        return false;
+    }
+    if(!pd->view(imode) || !pd->view(ienc) || !pd->view(ipos) || !(pd->view(iposd)) || !pd->view(iimp) || !pd->view(itrq))
+    {
+        cout<<"Problems acquiring interfaces for "<<part<<endl;
+        return false;
+    }
+    return true;
+}
+
+//---------------------------------------------------------
+// open drivers no compliance (simulation)
+//---------------------------------------------------------
+bool openDriversArm_noImpedance(Property &options, string robot, string part, PolyDriver *&pd, IPositionControl2 *&ipos, IPositionDirect *&iposd, IEncoders *&ienc, IControlMode2 *&imode)
+{
+    // open the device drivers
+    if(!options.check("device"))
+        options.put("device","remote_controlboard");
+    if(!options.check("local"))
+        options.put("local",string("/upperBodyPlayer/"+part).c_str());
+    options.put("remote",string("/"+robot+"/"+part).c_str());
+
+    if(!(pd->open(options)))
+    {
+        cout<<"Problems connecting to the remote driver of "<<part<<endl;
+        return false;
+    }
+    if(!(pd->isValid()))
+    {
+        printf("Device not available.  Here are the known devices:\n");
+        printf("%s", Drivers::factory().toString().c_str());
+        return false;
+    }
+    if(!(pd->view(imode)) || !(pd->view(ienc)) || !(pd->view(ipos)) || !(pd->view(iposd)))
+    {
+        cout<<"Problems acquiring interfaces for "<<part<<endl;
+        return false;
+    }
+    return true;
+}
+
+//---------------------------------------------------------
+// all the parts, in parallel
+//---------------------------------------------------------
+
+// what the openers share with openPartDrivers; it is owned by all of
+// them, so that a part answering after the deadline still finds it
+struct PartOpening
+{
+    Semaphore done;
+    Mutex mutex;
+    PartDrivers drivers[nBodyParts];    // copied in by each opener when it ends
+    bool finished[nBodyParts];
+    bool abandoned;                     // no one waits any more: a late opener closes its driver
+
+    PartOpening() : done(0), abandoned(false)
+    {
+        for(int p=0; p<nBodyParts; p++)
+            finished[p]=false;
+    }
+};
+
+static void openPart(shared_ptr<PartOpening> opening, int p, string robot, bool impedance, double timeout, int retries)
+{
+    string part=bodyPartNames[p];
+    PartDrivers drivers;
+    opening->mutex.lock();
+    drivers=opening->drivers[p];
+    opening->mutex.unlock();
+
+    double start=Time::now();
+    while(!drivers.ok && drivers.attempts<=retries)
+    {
+        drivers.attempts++;
+        double attempt=Time::now();
+        drivers.dd=new PolyDriver;
+        bool opened = impedance ?
+            openDriversArm(drivers.options, robot, part, drivers.dd, drivers.pos, drivers.posd, drivers.encs, drivers.ictrl, drivers.iimp, drivers.itrq) :
+            openDriversArm_noImpedance(drivers.options, robot, part, drivers.dd, drivers.pos, drivers.posd, drivers.encs, drivers.ictrl);
+        if(opened)
+        {
+            drivers.openTime=Time::now()-start;
+            int nj=0;
+            drivers.pos->getAxes(&nj);
+            drivers.encoders.resize(nj);
+            while(!(drivers.ok=drivers.encs->getEncoders(drivers.encoders.data())) && Time::now()-attempt<timeout)
+                Time::delay(0.01);
+            if(drivers.ok)
+                drivers.encodersTime=Time::now()-start-drivers.openTime;
+            else
+                cout<<"Problems reading the encoders of "<<part<<" after "<<timeout<<" s"<<endl;
+        }
+        if(!drivers.ok)
+        {
+            delete drivers.dd;
+            drivers.dd=0;
+            if(drivers.attempts<=retries)
+            {
+                cout<<"Trying again "<<part<<endl;
+                Time::delay(1.0);
+            }
+        }
+    }
+
+    opening->mutex.lock();
+    bool late=opening->abandoned;
+    if(!late)
+    {
+        opening->drivers[p]=drivers;
+        opening->finished[p]=true;
+    }
+    opening->mutex.unlock();
+    if(late && drivers.dd)
+    {
+        cout<<"Closing "<<part<<", opened after the deadline"<<endl;
+        delete drivers.dd;
+    }
+    opening->done.post();
+}
+
+bool openPartDrivers(const string &robot, const string &name, const string &device, bool impedance,
+                     double timeout, int retries, PartDrivers drivers[nBodyParts], int verbosity)
+{
+    double start=Time::now();
+    shared_ptr<PartOpening> opening=make_shared<PartOpening>();
+    for(int p=0; p<nBodyParts; p++)
+    {
+        drivers[p].dd=0;
+        drivers[p].attempts=0;
+        drivers[p].openTime=0.0;
+        drivers[p].encodersTime=0.0;
+        drivers[p].ok=false;
+        drivers[p].options.put("device",device.c_str());
+        drivers[p].options.put("local",(name+"/"+bodyPartNames[p]).c_str());
+        opening->drivers[p]=drivers[p];
+    }
+    for(int p=0; p<nBodyParts; p++)
+    {
+        if(verbosity>=1) cout<<"** Opening "<<bodyPartNames[p]<<" drivers"<<endl;
+        // detached: a part that never answers must not keep the caller
+        thread(openPart, opening, p, robot, impedance, timeout, retries).detach();
+    }
+
+    // the attempts of a part and the delays between them; this bounds
+    // the wait, not PolyDriver::open, which cannot be interrupted
+    double deadline=start+(timeout+1.0)*(retries+1);
+    int finished=0;
+    while(finished<nBodyParts && opening->done.waitWithTimeout(deadline-Time::now()))
+        finished++;
+
+    // the parts that ended in time, the others close their driver when they end
+    opening->mutex.lock();
+    opening->abandoned=true;
+    for(int p=0; p<nBodyParts; p++)
+        if(opening->finished[p])
+            drivers[p]=opening->drivers[p];
+    opening->mutex.unlock();
+
+    if(finished<nBodyParts)
+    {
+        cout<<"ERROR: "<<nBodyParts-finished<<" parts did not answer in "<<deadline-start<<" s"<<endl;
+        return false;
+    }
+
+    bool ok=true;
+    for(int p=0; p<nBodyParts; p++)
+    {
+        if(!drivers[p].ok)
+        {
+            cout<<"Error opening "<<bodyPartNames[p]<<" after "<<drivers[p].attempts<<" attempts"<<endl;
+            ok=false;
+        }
+    }
+
+    if(verbosity>=1)
+    {
+        cout<<"Startup of the drivers in "<<Time::now()-start<<" s:"<<endl;
+        for(int p=0; p<nBodyParts; p++)
+            cout<<"  "<<bodyPartNames[p]<<" : open "<<drivers[p].openTime<<" s, encoders "<<drivers[p].encodersTime
+                <<" s, "<<drivers[p].attempts<<(drivers[p].attempts>1 ? " attempts" : " attempt")<<endl;
+    }
+    return ok;
+}
+
+//---------------------------------------------------------
+// switch the joints of a part to direct position; the joints
+// that refuse are put back in position mode and flagged false
+//---------------------------------------------------------
+int setDirectMode(IControlMode2 *imode, int nj, const string &part, vector<bool> &direct)
+{
+    int failures=0;
+    direct.assign(nj, true);
+    for(int j=0; j<nj; j++)
+    {
+        if(!imode->setControlMode(j,VOCAB_CM_POSITION_DIRECT))
+        {
+            imode->setControlMode(j,VOCAB_CM_POSITION);
+            cout<<part<<": joint "<<j<<" cannot change direct position, it will use position"<<endl;
+            direct[j]=false;
+            failures++;
+        }
+    }
+    return failures;
+}
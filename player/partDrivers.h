@@ -0,0 +1,81 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#ifndef PART_DRIVERS_H
+#define PART_DRIVERS_H
+
+#include <string>
+#include <vector>
+#include <yarp/os/Property.h>
+#include <yarp/dev/ControlBoardInterfaces.h>
+#include <yarp/dev/PolyDriver.h>
+#include <yarp/dev/IPositionDirect.h>
+#include <yarp/sig/Vector.h>
+
+#include "wholeBodyTrajectory.h"
+
+//---------------------------------------------------------
+// remote_controlboard of a part of the robot (or options "device"
+// if it is set, e.g. mock_controlboard); the local port is options
+// "local" if it is set, /upperBodyPlayer/<part> otherwise
+//---------------------------------------------------------
+
+// with compliance (real robot)
+bool openDriversArm(yarp::os::Property &options, std::string robot, std::string part, yarp::dev::PolyDriver *&pd,
+                    yarp::dev::IPositionControl2 *&ipos, yarp::dev::IPositionDirect *&iposd, yarp::dev::IEncoders *&ienc,
+                    yarp::dev::IControlMode2 *&imode, yarp::dev::IImpedanceControl *&iimp, yarp::dev::ITorqueControl *&itrq);
+
+// no compliance (simulation)
+bool openDriversArm_noImpedance(yarp::os::Property &options, std::string robot, std::string part, yarp::dev::PolyDriver *&pd,
+                                yarp::dev::IPositionControl2 *&ipos, yarp::dev::IPositionDirect *&iposd, yarp::dev::IEncoders *&ienc,
+                                yarp::dev::IControlMode2 *&imode);
+
+//---------------------------------------------------------
+// open the drivers of all the played parts at the same time, one
+// thread per part: a part is ready when its interfaces are acquired
+// and its encoders read, each attempt has timeout seconds and a
+// failed part is tried again up to retries times. The timeout bounds
+// the wait only: PolyDriver::open cannot be interrupted, a part that
+// has not answered at the deadline is abandoned to its detached thread,
+// which closes the driver if it opens it later.
+//---------------------------------------------------------
+struct PartDrivers
+{
+    yarp::os::Property options;
+    yarp::dev::PolyDriver *dd;
+    yarp::dev::IPositionControl2 *pos;
+    yarp::dev::IPositionDirect *posd;
+    yarp::dev::IEncoders *encs;
+    yarp::dev::IControlMode2 *ictrl;
+    yarp::dev::IImpedanceControl *iimp;
+    yarp::dev::ITorqueControl *itrq;
+    yarp::sig::Vector encoders;     // the first reading
+    int attempts;
+    double openTime;                // seconds to open the driver and acquire the interfaces
+    double encodersTime;            // then seconds to the first encoders
+    bool ok;
+};
+
+// the local ports are <name>/<part>
+bool openPartDrivers(const std::string &robot, const std::string &name, const std::string &device, bool impedance,
+                     double timeout, int retries, PartDrivers drivers[nBodyParts], int verbosity);
+
+// switch the joints of a part to direct position; the joints that
+// refuse are put back in position mode and flagged false; returns
+// the number of them
+int setDirectMode(yarp::dev::IControlMode2 *imode, int nj, const std::string &part, std::vector<bool> &direct);
+
+#endif
@@ -0,0 +1,82 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#include "periodicScheduler.h"
+
+#include <string.h>
+
+//---------------------------------------------------------
+// PeriodicScheduler
+//---------------------------------------------------------
+PeriodicScheduler::PeriodicScheduler(double period, OverrunPolicy policy, PlayerClock &clock)
+    : tickPeriod(period), policy(policy), clock(clock), startTime(0.0), firstTick(0), tick(0),
+      nOverruns(0), nSkipped(0), maxLateness(0.0)
+{
+}
+
+void PeriodicScheduler::start(int first)
+{
+    startTime = clock.now();
+    firstTick = first;
+    tick = first-1;
+    nOverruns = 0;
+    nSkipped = 0;
+    maxLateness = 0.0;
+}
+
+int PeriodicScheduler::waitNextTick()
+{
+    tick++;
+    double now = clock.now();
+    double late = now-deadline(tick);
+    if(late<=0.0)
+    {
+        clock.delayUntil(deadline(tick));
+        return tick;
+    }
+
+    // the first tick is due at start(), it is not late
+    if(tick==firstTick)
+        return tick;
+
+    nOverruns++;
+    if(late>maxLateness)
+        maxLateness = late;
+    if(policy==OVERRUN_SKIP && late>=tickPeriod)
+    {
+        // the last tick whose deadline has passed
+        int due = firstTick+(int)((now-startTime)/tickPeriod);
+        nSkipped += due-tick;
+        tick = due;
+    }
+    return tick;
+}
+
+double PeriodicScheduler::elapsed() const
+{
+    return clock.now()-startTime;
+}
+
+bool parseOverrunPolicy(const char *name, OverrunPolicy &policy)
+{
+    if(strcmp(name, "skip")==0)
+        policy = OVERRUN_SKIP;
+    else if(strcmp(name, "catchup")==0)
+        policy = OVERRUN_CATCH_UP;
+    else
+        return false;
+    return true;
+}
@@ -0,0 +1,73 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#ifndef PERIODIC_SCHEDULER_H
+#define PERIODIC_SCHEDULER_H
+
+#include "playerClock.h"
+
+//---------------------------------------------------------
+// what to do with the ticks whose deadline has already passed
+// when the previous one is done
+//---------------------------------------------------------
+enum OverrunPolicy
+{
+    OVERRUN_SKIP=0,     // drop them and go on with the tick that is due now
+    OVERRUN_CATCH_UP    // run them back to back until the schedule is met again
+};
+
+//---------------------------------------------------------
+// periodic executor on absolute deadlines: tick k is due at
+// start+(k-first)*period, so the time spent between two ticks
+// does not accumulate as drift; the time is the one of clock
+//---------------------------------------------------------
+class PeriodicScheduler
+{
+public:
+    PeriodicScheduler(double period, OverrunPolicy policy=OVERRUN_SKIP, PlayerClock &clock=systemClock());
+
+    // tick first is due now
+    void start(int first=0);
+
+    // sleep until the next tick is due and return it
+    int waitNextTick();
+
+    double period() const { return tickPeriod; }
+    double deadline(int tick) const { return startTime+(tick-firstTick)*tickPeriod; }
+
+    // seconds since start()
+    double elapsed() const;
+
+    int overruns() const { return nOverruns; }          // ticks that started after their deadline
+    int skippedTicks() const { return nSkipped; }       // ticks dropped by OVERRUN_SKIP
+    double worstLateness() const { return maxLateness; }
+
+private:
+    double tickPeriod;
+    OverrunPolicy policy;
+    PlayerClock &clock;
+    double startTime;
+    int firstTick;
+    int tick;
+    int nOverruns;
+    int nSkipped;
+    double maxLateness;
+};
+
+// "skip" or "catchup"; false if the name is unknown
+bool parseOverrunPolicy(const char *name, OverrunPolicy &policy);
+
+#endif
@@ -0,0 +1,62 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#include "playerClock.h"
+
+#include <time.h>
+#include <yarp/os/Time.h>
+
+using namespace yarp::os;
+
+//---------------------------------------------------------
+// system time
+//---------------------------------------------------------
+class SystemClock : public PlayerClock
+{
+public:
+    virtual double now() const { return Time::now(); }
+    virtual void delay(double seconds) { Time::delay(seconds); }
+    virtual void delayUntil(double time) { Time::delay(time-Time::now()); }
+    virtual bool isVirtual() const { return false; }
+};
+
+PlayerClock &systemClock()
+{
+    static SystemClock clock;
+    return clock;
+}
+
+double monotonicTime()
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec+t.tv_nsec*1e-9;
+}
+
+//---------------------------------------------------------
+// VirtualClock
+//---------------------------------------------------------
+void VirtualClock::delay(double seconds)
+{
+    if(seconds>0.0)
+        time.store(time.load(std::memory_order_relaxed)+seconds, std::memory_order_release);
+}
+
+void VirtualClock::delayUntil(double t)
+{
+    if(t>time.load(std::memory_order_relaxed))
+        time.store(t, std::memory_order_release);
+}
@@ -0,0 +1,65 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#ifndef PLAYER_CLOCK_H
+#define PLAYER_CLOCK_H
+
+#include <atomic>
+
+//---------------------------------------------------------
+// the time of the playing loop
+//---------------------------------------------------------
+class PlayerClock
+{
+public:
+    virtual ~PlayerClock() {}
+
+    virtual double now() const = 0;
+    virtual void delay(double seconds) = 0;
+    // until now() is time, exactly for a virtual clock
+    virtual void delayUntil(double time) = 0;
+
+    // true if the time only moves when the loop waits
+    virtual bool isVirtual() const = 0;
+};
+
+// Time::now and Time::delay, shared by everyone
+PlayerClock &systemClock();
+
+// seconds of a monotonic clock, for the durations measured in the
+// loop: Time::now can be the clock of a simulator, and jumps with NTP
+double monotonicTime();
+
+//---------------------------------------------------------
+// time that starts at 0 and jumps to the end of every delay without
+// waiting, so that a loop on it runs as fast as the CPU allows. Only
+// one thread may delay it; the others can read it.
+//---------------------------------------------------------
+class VirtualClock : public PlayerClock
+{
+public:
+    VirtualClock() : time(0.0) {}
+
+    virtual double now() const { return time.load(std::memory_order_acquire); }
+    virtual void delay(double seconds);
+    virtual void delayUntil(double time);
+    virtual bool isVirtual() const { return true; }
+
+private:
+    std::atomic<double> time;
+};
+
+#endif
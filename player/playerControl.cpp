@@ -0,0 +1,147 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#include "playerControl.h"
+
+#include <iostream>
+#include <sstream>
+#include <yarp/os/Bottle.h>
+
+using namespace yarp::os;
+using namespace std;
+
+//---------------------------------------------------------
+// PlayerCommandQueue
+//---------------------------------------------------------
+bool PlayerCommandQueue::push(const PlayerCommand &command)
+{
+    unsigned t = tail.load(std::memory_order_relaxed);
+    if(t-head.load(std::memory_order_acquire)==capacity)
+        return false;
+    items[t%capacity] = command;
+    tail.store(t+1, std::memory_order_release);
+    return true;
+}
+
+bool PlayerCommandQueue::pop(PlayerCommand &command)
+{
+    unsigned h = head.load(std::memory_order_relaxed);
+    if(h==tail.load(std::memory_order_acquire))
+        return false;
+    command = items[h%capacity];
+    head.store(h+1, std::memory_order_release);
+    return true;
+}
+
+//---------------------------------------------------------
+// PlayerRpc
+//---------------------------------------------------------
+static const char *commandList = "commands are pause, resume, seek <frame>, speed <factor>, stop, status, help";
+
+PlayerRpc::PlayerRpc(const string &portName, int nFrames, PlayerCommandQueue &queue, const PlayerStatus &status)
+    : portName(portName), nFrames(nFrames), queue(queue), status(status)
+{
+}
+
+bool PlayerRpc::threadInit()
+{
+    if(!port.open(portName.c_str()))
+    {
+        cout<<"ERROR: cannot open the rpc port "<<portName<<endl;
+        return false;
+    }
+    return true;
+}
+
+void PlayerRpc::run()
+{
+    while(!isStopping())
+    {
+        Bottle command, reply;
+        if(!port.read(command, true))
+            continue;
+
+        string name = command.get(0).asString().c_str();
+        PlayerCommand c;
+        c.value = 0.0;
+        bool known = true;
+        if(name=="pause")
+            c.type = PLAYER_PAUSE;
+        else if(name=="resume")
+            c.type = PLAYER_RESUME;
+        else if(name=="stop")
+            c.type = PLAYER_STOP;
+        else if(name=="seek")
+        {
+            c.type = PLAYER_SEEK;
+            c.value = command.get(1).asInt();
+            if(command.size()<2 || c.value<0 || c.value>=nFrames)
+            {
+                stringstream error;
+                error<<"error: seek needs a frame in 0.."<<nFrames-1;
+                reply.addString(error.str().c_str());
+                port.reply(reply);
+                continue;
+            }
+        }
+        else if(name=="speed")
+        {
+            c.type = PLAYER_SPEED;
+            c.value = command.get(1).asDouble();
+            if(command.size()<2 || c.value<=0.0 || c.value>4.0)
+            {
+                reply.addString("error: speed needs a factor in ]0,4]");
+                port.reply(reply);
+                continue;
+            }
+        }
+        else if(name=="help")
+        {
+            reply.addString(commandList);
+            port.reply(reply);
+            continue;
+        }
+        else if(name=="status")
+        {
+            stringstream s;
+            s<<"frame "<<status.frame.load()<<" of "<<nFrames<<(status.paused.load() ? ", paused" : ", playing")
+             <<", speed "<<status.speed.load();
+            reply.addString(s.str().c_str());
+            port.reply(reply);
+            continue;
+        }
+        else
+            known = false;
+
+        if(!known)
+            reply.addString((string("error: ")+commandList).c_str());
+        else if(!queue.push(c))
+            reply.addString("error: too many pending commands");
+        else
+            reply.addString("ok");
+        port.reply(reply);
+    }
+}
+
+void PlayerRpc::onStop()
+{
+    port.interrupt();
+}
+
+void PlayerRpc::threadRelease()
+{
+    port.close();
+}
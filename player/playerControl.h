@@ -0,0 +1,99 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#ifndef PLAYER_CONTROL_H
+#define PLAYER_CONTROL_H
+
+#include <atomic>
+#include <string>
+#include <yarp/os/RpcServer.h>
+#include <yarp/os/Thread.h>
+
+//---------------------------------------------------------
+// commands to the playing loop
+//---------------------------------------------------------
+enum PlayerCommandType
+{
+    PLAYER_PAUSE=0,
+    PLAYER_RESUME,
+    PLAYER_SEEK,        // value: frame
+    PLAYER_SPEED,       // value: factor of the rate of the trajectory
+    PLAYER_STOP
+};
+
+struct PlayerCommand
+{
+    PlayerCommandType type;
+    double value;
+};
+
+//---------------------------------------------------------
+// single producer (the rpc thread), single consumer (the playing
+// loop) ring buffer: neither side ever waits for the other
+//---------------------------------------------------------
+class PlayerCommandQueue
+{
+public:
+    PlayerCommandQueue() : head(0), tail(0) {}
+
+    // false if the queue is full
+    bool push(const PlayerCommand &command);
+
+    // false if the queue is empty
+    bool pop(PlayerCommand &command);
+
+private:
+    static const unsigned capacity = 64;
+    PlayerCommand items[capacity];
+    std::atomic<unsigned> head;     // next to pop
+    std::atomic<unsigned> tail;     // next to push
+};
+
+//---------------------------------------------------------
+// what the playing loop publishes for the status command
+//---------------------------------------------------------
+struct PlayerStatus
+{
+    std::atomic<int> frame;
+    std::atomic<bool> paused;
+    std::atomic<double> speed;
+
+    PlayerStatus() : frame(0), paused(false), speed(1.0) {}
+};
+
+//---------------------------------------------------------
+// rpc port of the player: pause, resume, seek <frame>,
+// speed <factor>, stop, status, help
+//---------------------------------------------------------
+class PlayerRpc : public yarp::os::Thread
+{
+public:
+    PlayerRpc(const std::string &portName, int nFrames, PlayerCommandQueue &queue, const PlayerStatus &status);
+
+    virtual bool threadInit();
+    virtual void run();
+    virtual void onStop();
+    virtual void threadRelease();
+
+private:
+    std::string portName;
+    int nFrames;
+    PlayerCommandQueue &queue;
+    const PlayerStatus &status;
+    yarp::os::RpcServer port;
+};
+
+#endif
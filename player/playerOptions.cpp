@@ -0,0 +1,151 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#include "playerOptions.h"
+
+#include <iostream>
+#include <yarp/os/Value.h>
+
+using namespace yarp::os;
+using namespace std;
+
+void readTrajectoryPlayerOptions(Searchable &params, TrajectoryPlayerOptions &options)
+{
+    if (!params.check("robot"))
+        cout<<"==> Missing robot name, setting default"<<endl;
+    else
+        options.robot=params.find("robot").asString().c_str();
+
+    if (!params.check("verbosity"))
+        cout<<"==> Missing verbosity, setting default"<<endl;
+    else
+        options.verbosity=params.find("verbosity").asInt();
+
+    if (!params.check("start"))
+        cout<<"==> Missing start, setting default"<<endl;
+    else
+    {
+        options.first=params.find("start").asInt();
+        if(options.first<0)
+        {
+            cout<<"Warning: Starting point must be >=0"<<endl;
+            options.first=0;
+        }
+    }
+
+    if (params.check("rate"))
+    {
+        double rate=params.find("rate").asDouble();
+        if(rate>0.0)
+            options.rate=options.recordingRate=rate;
+        else
+            cout<<"Warning: the rate must be >0, setting "<<options.rate<<endl;
+    }
+
+    if (params.check("overrun") && !parseOverrunPolicy(params.find("overrun").asString().c_str(), options.overrunPolicy))
+    {
+        cout<<"Warning: unknown overrun policy "<<params.find("overrun").asString()<<", setting skip"<<endl;
+        options.overrunPolicy=OVERRUN_SKIP;
+    }
+
+    if (params.check("mode"))
+    {
+        string mode=params.find("mode").asString().c_str();
+        if(mode=="direct" || mode=="position")
+            options.directMode=(mode=="direct");
+        else
+            cout<<"Warning: unknown mode "<<mode<<", setting "<<(options.directMode ? "direct" : "position")<<endl;
+    }
+
+    if (params.check("dispatch"))
+    {
+        string dispatch=params.find("dispatch").asString().c_str();
+        if(dispatch=="concurrent" || dispatch=="sequential")
+            options.concurrentDispatch=(dispatch=="concurrent");
+        else
+            cout<<"Warning: unknown dispatch "<<dispatch<<", setting "<<(options.concurrentDispatch ? "concurrent" : "sequential")<<endl;
+    }
+
+    if (params.check("rpc"))
+        options.rpcName=params.find("rpc").asString().c_str();
+
+    if (params.check("timing"))
+        options.timingFile=params.find("timing").asString().c_str();
+    if (params.check("telemetry"))
+        options.telemetryFile=params.find("telemetry").asString().c_str();
+    if (params.check("telemetryEncoders"))
+        options.telemetryEncoders=true;
+
+    if (params.check("device"))
+        options.device=params.find("device").asString().c_str();
+    if (params.check("deviceFile"))
+        options.deviceFile=params.find("deviceFile").asString().c_str();
+    if (params.check("virtual"))
+        options.virtualClock=true;
+
+    if (params.check("rt"))
+    {
+        options.realTime.enabled=true;
+        if (params.check("rtpriority"))
+            options.realTime.priority=params.find("rtpriority").asInt();
+        if (params.check("rtcpus") && !parseCpuList(params.find("rtcpus").asString().c_str(), options.realTime.cpus))
+        {
+            cout<<"Warning: cannot read the cpus "<<params.find("rtcpus").asString()<<", using any cpu"<<endl;
+            options.realTime.cpus.clear();
+        }
+    }
+
+    if (params.check("timeout"))
+        options.driversTimeout=params.find("timeout").asDouble();
+    if (params.check("retries"))
+        options.driversRetries=params.find("retries").asInt();
+
+    if (params.check("approachSpeed"))
+    {
+        double speed=params.find("approachSpeed").asDouble();
+        if(speed>0.0)
+            options.approachSpeed=speed;
+        else
+            cout<<"Warning: the approach speed must be >0, setting "<<options.approachSpeed<<endl;
+    }
+}
+
+void printTrajectoryPlayerOptions(ostream &out, const TrajectoryPlayerOptions &defaults)
+{
+    out<<" Player options: --robot ROBOTNAME --verbosity LEVEL --start STARTPOINT --rate RATE --overrun POLICY --mode MODE --dispatch DISPATCH [--rt [--rtpriority PRIORITY] [--rtcpus CPUS]] --timeout TIMEOUT --retries RETRIES --approachSpeed SPEED [--rpc PORT] [--timing TIMINGFILE] [--telemetry TELEMETRYFILE [--telemetryEncoders]] [--device DEVICE [--deviceFile DEVICEFILE] [--virtual]]"<<endl
+        <<" RATE is the playing rate in Hz of the text files, and the maximum rate of the others (they are decimated to it);"<<endl
+        <<"      a recording directory is played at its own rate, and resampled at RATE only if it is given"<<endl
+        <<" POLICY is what to do when a frame is late: skip (to the frame that is due) or catchup (play the late frames back to back)"<<endl
+        <<" MODE is position (positionMove of every frame) or direct (setPositions streamed at "<<defaults.directRate<<" Hz or more, interpolating the frames)"<<endl
+        <<" DISPATCH is concurrent (one thread per part, all the parts get a frame at the same time) or sequential"<<endl
+        <<" --rt plays in a SCHED_FIFO thread at PRIORITY (1..99) on the CPUS (e.g. 2,3), with the memory locked"<<endl
+        <<" TIMEOUT is the time in seconds given to a part to open its driver and read its encoders, RETRIES the attempts after a failure"<<endl
+        <<"         (it bounds the wait, not the opening itself: a part that has not answered by then is abandoned and the player stops)"<<endl
+        <<" SPEED is the peak velocity in deg/s of the minimum-jerk movement to the starting frame"<<endl
+        <<" --rpc opens the PORT (e.g. /bodyPlayer/rpc) for: pause, resume, seek FRAME, speed FACTOR, stop, status"<<endl
+        <<"       the end of the trajectory is then held until stop"<<endl
+        <<" TIMINGFILE receives the histograms of the loop timing (period error, safety check, send of each part), also printed at the end"<<endl
+        <<" TELEMETRYFILE receives every command sent by the loop, and the latest encoders with --telemetryEncoders (binary, see telemetryRecorder.h)"<<endl
+        <<" DEVICE is remote_controlboard, or mock_controlboard to play in process without robot nor YARP network"<<endl
+        <<"        or sim_controlboard, in process too, whose joints follow the commands as first order servos"<<endl
+        <<" DEVICEFILE is the servo parameters of sim_controlboard (see simulatedControlBoard.ini)"<<endl
+        <<" --virtual plays on a virtual clock, as fast as possible (not with remote_controlboard)"<<endl
+        <<" Default values: robot="<<defaults.robot<<" verbosity="<<defaults.verbosity<<" startpoint="<<defaults.first<<" rate="<<defaults.rate
+        <<" overrun="<<(defaults.overrunPolicy==OVERRUN_SKIP ? "skip" : "catchup")<<" mode="<<(defaults.directMode ? "direct" : "position")
+        <<" dispatch="<<(defaults.concurrentDispatch ? "concurrent" : "sequential")<<" priority="<<defaults.realTime.priority<<" cpus=any"
+        <<" timeout="<<defaults.driversTimeout<<" retries="<<defaults.driversRetries<<" approachSpeed="<<defaults.approachSpeed
+        <<" device="<<defaults.device<<endl;
+}
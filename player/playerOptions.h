@@ -0,0 +1,37 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#ifndef PLAYER_OPTIONS_H
+#define PLAYER_OPTIONS_H
+
+#include <ostream>
+#include <yarp/os/Searchable.h>
+
+#include "trajectoryPlayer.h"
+
+//---------------------------------------------------------
+// the command line of the programs that play a trajectory
+// (--robot, --rate, --mode, ..., see printTrajectoryPlayerOptions)
+//---------------------------------------------------------
+
+// the options found in params, the others keep their value; a wrong
+// value is reported and keeps its value too
+void readTrajectoryPlayerOptions(yarp::os::Searchable &params, TrajectoryPlayerOptions &options);
+
+// the usage of these options, then one line for each, with the defaults
+void printTrajectoryPlayerOptions(std::ostream &out, const TrajectoryPlayerOptions &defaults);
+
+#endif
@@ -0,0 +1,157 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#include "realTime.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <iostream>
+
+using namespace std;
+
+bool parseCpuList(const string &list, vector<int> &cpus)
+{
+    cpus.clear();
+    const char *p = list.c_str();
+    while(*p)
+    {
+        char *end;
+        long cpu = strtol(p, &end, 10);
+        if(end==p || cpu<0 || cpu>=CPU_SETSIZE)
+            return false;
+        cpus.push_back((int)cpu);
+        p = end;
+        if(*p==',')
+            p++;
+        else if(*p)
+            return false;
+    }
+    return !cpus.empty();
+}
+
+bool lockProcessMemory()
+{
+    if(mlockall(MCL_CURRENT|MCL_FUTURE)!=0)
+    {
+        cout<<"WARNING: mlockall failed ("<<strerror(errno)<<"), the memory may be paged"<<endl;
+        return false;
+    }
+    return true;
+}
+
+bool makeThreadRealTime(int priority, const vector<int> &cpus)
+{
+    bool ok=true;
+
+    sched_param param;
+    memset(&param, 0, sizeof(param));
+    param.sched_priority = priority;
+    int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if(err!=0)
+    {
+        cout<<"WARNING: SCHED_FIFO priority "<<priority<<" refused ("<<strerror(err)<<")"<<endl;
+        ok = false;
+    }
+
+    if(!cpus.empty())
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for(size_t k=0; k<cpus.size(); k++)
+            CPU_SET(cpus[k], &set);
+        err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if(err!=0)
+        {
+            cout<<"WARNING: cpu affinity refused ("<<strerror(err)<<")"<<endl;
+            ok = false;
+        }
+    }
+
+    // with the memory locked, this maps the stack the thread will use
+    volatile char stack[64*1024];
+    memset((char *)stack, 0, sizeof(stack));
+
+    return ok;
+}
+
+//---------------------------------------------------------
+// allocation accounting
+//---------------------------------------------------------
+static thread_local int noAllocationDepth = 0;
+static long nForbiddenAllocations = 0;
+static long nAllocations = 0;
+static long nAllocatedBytes = 0;
+static bool countingAllocations = false;
+
+NoAllocationScope::NoAllocationScope()
+{
+    noAllocationDepth++;
+}
+
+NoAllocationScope::~NoAllocationScope()
+{
+    noAllocationDepth--;
+}
+
+AllocationAllowedScope::AllocationAllowedScope() : saved(noAllocationDepth)
+{
+    noAllocationDepth = 0;
+}
+
+AllocationAllowedScope::~AllocationAllowedScope()
+{
+    noAllocationDepth = saved;
+}
+
+bool allocationsCounted()
+{
+    return countingAllocations;
+}
+
+void setAllocationsCounted()
+{
+    countingAllocations = true;
+}
+
+bool countAllocation(size_t size)
+{
+    __sync_fetch_and_add(&nAllocations, 1);
+    __sync_fetch_and_add(&nAllocatedBytes, (long)size);
+    if(noAllocationDepth==0)
+        return false;
+    __sync_fetch_and_add(&nForbiddenAllocations, 1);
+    return true;
+}
+
+long forbiddenAllocations()
+{
+    return __sync_fetch_and_add(&nForbiddenAllocations, 0);
+}
+
+long allocations()
+{
+    return __sync_fetch_and_add(&nAllocations, 0);
+}
+
+long allocatedBytes()
+{
+    return __sync_fetch_and_add(&nAllocatedBytes, 0);
+}
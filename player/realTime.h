@@ -0,0 +1,86 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#ifndef REAL_TIME_H
+#define REAL_TIME_H
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+//---------------------------------------------------------
+// real-time settings of the playing threads (opt-in, see --rt)
+//---------------------------------------------------------
+struct RealTimeOptions
+{
+    bool enabled;
+    int priority;               // SCHED_FIFO priority, 1..99
+    std::vector<int> cpus;      // affinity of the threads, empty for any cpu
+
+    RealTimeOptions() : enabled(false), priority(80) {}
+};
+
+// "2,3" -> {2, 3}; false if it is not a list of cpu numbers
+bool parseCpuList(const std::string &list, std::vector<int> &cpus);
+
+// lock the pages of the process in memory, the current and the future ones
+bool lockProcessMemory();
+
+// SCHED_FIFO at priority and affinity to cpus for the calling thread;
+// its stack is touched so that it does not page fault later
+bool makeThreadRealTime(int priority, const std::vector<int> &cpus);
+
+//---------------------------------------------------------
+// the allocations made by a thread inside a NoAllocationScope: there
+// should be none in the playing loop once the buffers are allocated.
+// The calls to the devices are outside of our control, they are in an
+// AllocationAllowedScope. They are counted by the operator new of
+// allocationCheck.cpp, which is linked in the programs that want it
+// (bodyPlayer, playerBenchmark), not in the library.
+//---------------------------------------------------------
+class NoAllocationScope
+{
+public:
+    NoAllocationScope();
+    ~NoAllocationScope();
+};
+
+class AllocationAllowedScope
+{
+public:
+    AllocationAllowedScope();
+    ~AllocationAllowedScope();
+private:
+    int saved;
+};
+
+// false if the program has no allocationCheck.cpp: nothing is counted
+bool allocationsCounted();
+
+// allocations counted so far in the NoAllocationScopes, all threads
+long forbiddenAllocations();
+
+// all the allocations (and their bytes) so far, all threads, e.g. the
+// difference around a step of the pipeline
+long allocations();
+long allocatedBytes();
+
+// for allocationCheck.cpp: count an allocation of the calling thread,
+// true if it is in a NoAllocationScope
+bool countAllocation(size_t size);
+void setAllocationsCounted();
+
+#endif
@@ -0,0 +1,221 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#include "rigidBodyReader.h"
+#include "mappedFile.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+
+using namespace yarp::sig;
+using namespace std;
+
+// size of the text chunk read from the file; grown only for longer lines
+static const size_t chunkSize = 64*1024;
+
+static string trim(const char *begin, const char *end)
+{
+    while(begin<end && (*begin==' ' || *begin=='\t' || *begin=='\r'))
+        begin++;
+    while(end>begin && (end[-1]==' ' || end[-1]=='\t' || end[-1]=='\r'))
+        end--;
+    return string(begin, end);
+}
+
+//---------------------------------------------------------
+// RigidBodyReader
+//---------------------------------------------------------
+RigidBodyReader::RigidBodyReader() : file(0), head(0), tail(0), lineNumber(0), nFrames(0), freq(0.0)
+{
+}
+
+RigidBodyReader::~RigidBodyReader()
+{
+    close();
+}
+
+bool RigidBodyReader::isRigidBodyFile(const string &filename)
+{
+    FILE *f = fopen(filename.c_str(), "rb");
+    if(!f)
+        return false;
+    char start[16];
+    size_t n = fread(start, 1, sizeof(start), f);
+    fclose(f);
+    return n>=16 && strncmp(start, "Number of frames", 16)==0;
+}
+
+bool RigidBodyReader::open(const string &filename)
+{
+    close();
+
+    file = fopen(filename.c_str(), "rb");
+    if(!file)
+    {
+        cout<<"ERROR: Can't open file: "<<filename<<endl;
+        return false;
+    }
+    buffer.resize(chunkSize);
+
+    // header block, until the line with the column names
+    const char *begin, *end;
+    while(nextLine(begin, end))
+    {
+        string line = trim(begin, end);
+        if(line.empty())
+            continue;
+
+        if(line.compare(0, 5, "Frame")==0)
+        {
+            // tab separated names, the export pads lines with empty cells
+            const char *p = begin;
+            while(p<end)
+            {
+                const char *q = static_cast<const char *>(memchr(p, '\t', end-p));
+                if(!q) q = end;
+                string name = trim(p, q);
+                if(!name.empty())
+                    columnNames.push_back(name);
+                p = q+1;
+            }
+            return true;
+        }
+
+        size_t colon = line.find(':');
+        if(colon==string::npos)
+        {
+            cout<<"ERROR: "<<filename<<" line "<<lineNumber<<": unexpected header line"<<endl;
+            close();
+            return false;
+        }
+        string key = line.substr(0, colon);
+        string value = trim(line.c_str()+colon+1, line.c_str()+line.size());
+        if(key=="Number of frames")
+            nFrames = atoi(value.c_str());
+        else if(key=="Frequency")
+            freq = atof(value.c_str());
+        else if(key=="Units")
+            unitsName = value;
+    }
+
+    cout<<"ERROR: "<<filename<<" has no column names"<<endl;
+    close();
+    return false;
+}
+
+void RigidBodyReader::close()
+{
+    if(file)
+        fclose(file);
+    file = 0;
+    buffer.clear();
+    head = tail = 0;
+    lineNumber = 0;
+    nFrames = 0;
+    freq = 0.0;
+    unitsName.clear();
+    columnNames.clear();
+}
+
+int RigidBodyReader::findColumn(const string &segment, const string &channel) const
+{
+    string name = segment+" "+channel;
+    for(size_t c=0; c<columnNames.size(); c++)
+        if(columnNames[c]==name)
+            return (int)c;
+    return -1;
+}
+
+bool RigidBodyReader::nextLine(const char *&begin, const char *&end)
+{
+    if(!file)
+        return false;
+
+    while(true)
+    {
+        char *first = &buffer[0]+head;
+        char *nl = static_cast<char *>(memchr(first, '\n', tail-head));
+        if(nl)
+        {
+            begin = first;
+            end = nl;
+            head = nl-&buffer[0]+1;
+            lineNumber++;
+            return true;
+        }
+
+        // keep the partial line and refill behind it
+        memmove(&buffer[0], first, tail-head);
+        tail -= head;
+        head = 0;
+        if(tail==buffer.size())
+            buffer.resize(2*buffer.size());
+
+        size_t n = fread(&buffer[0]+tail, 1, buffer.size()-tail, file);
+        if(n==0)
+        {
+            // last line without a newline
+            if(tail==0)
+                return false;
+            begin = &buffer[0];
+            end = begin+tail;
+            head = tail = 0;
+            lineNumber++;
+            return true;
+        }
+        tail += n;
+    }
+}
+
+int RigidBodyReader::readFrames(Matrix &chunk, int maxFrames)
+{
+    int nColumns = numberOfColumns();
+    if(chunk.rows()!=maxFrames || chunk.cols()!=nColumns)
+        chunk.resize(maxFrames, nColumns);
+
+    int n=0;
+    const char *begin, *end;
+    while(n<maxFrames && nextLine(begin, end))
+    {
+        const char *p = begin;
+        skipBlanks(p, end);
+        if(p==end)
+            continue;
+
+        // cells are tab separated; an empty cell is a marker lost by the
+        // capture system and is read as NaN
+        double *row = chunk[n];
+        for(int c=0; c<nColumns; c++)
+        {
+            const char *cell = p;
+            while(cell<end && (*cell==' ' || *cell=='\r'))
+                cell++;
+            if(cell==end || *cell=='\t')
+                row[c] = NAN;
+            else if(!parseDouble(p, end, row[c]))
+            {
+                cout<<"ERROR: line "<<lineNumber<<" column "<<c<<" is not a number"<<endl;
+                return -1;
+            }
+            p = static_cast<const char *>(memchr(p, '\t', end-p));
+            p = p ? p+1 : end;
+        }
+        n++;
+    }
+    return n;
+}
@@ -0,0 +1,78 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#ifndef RIGID_BODY_READER_H
+#define RIGID_BODY_READER_H
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <yarp/sig/Matrix.h>
+
+//---------------------------------------------------------
+// streaming reader for the motion capture rigid body export
+// (sit2stand-rigid.txt): a "Key: value" header, a tab separated
+// line of column names ("Frame", "smart_thigh Rz", ...) and one
+// line per frame. Only one chunk of text is in memory at a time.
+//---------------------------------------------------------
+class RigidBodyReader
+{
+public:
+    RigidBodyReader();
+    ~RigidBodyReader();
+
+    // true if the file starts with the rigid body header
+    static bool isRigidBodyFile(const std::string &filename);
+
+    // open the file and parse the header up to the column names
+    bool open(const std::string &filename);
+    void close();
+
+    int numberOfFrames() const { return nFrames; }
+    double frequency() const { return freq; }
+    const std::string &units() const { return unitsName; }
+
+    // column 0 is the frame number
+    int numberOfColumns() const { return (int)columnNames.size(); }
+    const std::string &columnName(int c) const { return columnNames[c]; }
+
+    // index of "segment channel" (e.g. "smart_thigh", "Ry"), -1 if missing
+    int findColumn(const std::string &segment, const std::string &channel) const;
+
+    // read up to maxFrames frames, one per row of chunk (resized only if needed),
+    // missing cells are NaN; returns the number of frames read, 0 at the end
+    // of the file, -1 on errors
+    int readFrames(yarp::sig::Matrix &chunk, int maxFrames);
+
+private:
+    RigidBodyReader(const RigidBodyReader &);
+    RigidBodyReader &operator=(const RigidBodyReader &);
+
+    // next complete line in the buffer, refilling it from the file if needed
+    bool nextLine(const char *&begin, const char *&end);
+
+    FILE *file;
+    std::vector<char> buffer;
+    size_t head, tail;
+    int lineNumber;
+
+    int nFrames;
+    double freq;
+    std::string unitsName;
+    std::vector<std::string> columnNames;
+};
+
+#endif
@@ -0,0 +1,329 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#include "robotData.h"
+#include "mappedFile.h"
+#include "dumperLogIndex.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <yarp/os/Thread.h>
+
+using namespace yarp::os;
+using namespace yarp::sig;
+using namespace std;
+
+const RobotDataPart robotDataParts[nRobotDataParts] =
+{
+    { "head",     "head" },
+    { "torso",    "torso" },
+    { "leftArm",  "left_arm" },
+    { "rightArm", "right_arm" },
+    { "leftLeg",  "left_leg" },
+    { "rightLeg", "right_leg" },
+    { "inertial", "" }
+};
+
+//---------------------------------------------------------
+// one part
+//---------------------------------------------------------
+
+// the rows of [from, to) with start <= timestamp <= end, knowing that
+// the rows before from have timestamps up to before
+static bool parseDumperRows(const string &dataName, const char *from, const char *to, double before,
+                            double start, double end, DumperLog &log)
+{
+    const char *p = from;
+    int lineNumber=0;
+    int dropped=0;
+    double latest=before;
+    vector<double> row;
+
+    while(p<to)
+    {
+        lineNumber++;
+        const char *rowStart = p;
+        skipBlanks(p, to);
+        if(p==to || *p=='\n')
+        {
+            skipLine(p, to);
+            continue;
+        }
+
+        double seq, timestamp, v;
+        bool ok = parseDouble(p, to, seq) && parseDouble(p, to, timestamp);
+        row.clear();
+        skipBlanks(p, to);
+        while(ok && p<to && *p!='\n')
+        {
+            ok = parseDouble(p, to, v);
+            row.push_back(v);
+            skipBlanks(p, to);
+        }
+        skipLine(p, to);
+
+        if(log.nValues==0 && ok)
+        {
+            // the first row fixes the size; reserve from the bytes to parse
+            log.nValues = (int)row.size();
+            size_t rows = (to-from)/(p-rowStart)+1;
+            log.sequence.reserve(rows);
+            log.timestamps.reserve(rows);
+            log.values.reserve(rows*log.nValues);
+        }
+        if(!ok || (int)row.size()!=log.nValues)
+        {
+            // the dumper may be killed in the middle of the last row
+            if(p==to)
+            {
+                cout<<"WARNING: "<<dataName<<" ends with an incomplete row, ignored"<<endl;
+                break;
+            }
+            cout<<"ERROR: "<<dataName<<" line "<<lineNumber<<(before==-HUGE_VAL ? "" : " from the indexed row")
+                <<" has "<<row.size()<<" values instead of "<<log.nValues<<endl;
+            return false;
+        }
+
+        // the samples must be in time order for the alignment
+        if(timestamp<=latest)
+        {
+            dropped++;
+            continue;
+        }
+        latest = timestamp;
+        if(timestamp<start)
+            continue;
+        if(timestamp>end)
+            break;
+
+        log.sequence.push_back((int)seq);
+        log.timestamps.push_back(timestamp);
+        log.values.insert(log.values.end(), row.begin(), row.end());
+    }
+
+    if(dropped>0)
+        cout<<"WARNING: "<<dataName<<": "<<dropped<<" samples out of time order were dropped"<<endl;
+    if(log.timestamps.empty())
+    {
+        cout<<"ERROR: "<<dataName<<" has no samples"<<(start>-HUGE_VAL || end<HUGE_VAL ? " in the window" : "")<<endl;
+        return false;
+    }
+    return true;
+}
+
+bool loadDumperLog(const string &directory, const string &part, DumperLog &log)
+{
+    return loadDumperLog(directory, part, -HUGE_VAL, HUGE_VAL, log);
+}
+
+bool loadDumperLog(const string &directory, const string &part, double start, double end, DumperLog &log)
+{
+    string dataName = directory+"/"+part+"/data.log";
+    string infoName = directory+"/"+part+"/info.log";
+
+    log.part = part;
+    log.port.clear();
+    log.nValues = 0;
+    log.sequence.clear();
+    log.timestamps.clear();
+    log.values.clear();
+
+    // second line of info.log: "[timestamp] /port/name [connected]"
+    ifstream info(infoName.c_str());
+    string line;
+    if(getline(info, line) && getline(info, line))
+    {
+        size_t p = line.find(']');
+        stringstream ss(line.substr(p==string::npos ? 0 : p+1));
+        ss >> log.port;
+    }
+
+    MappedFile file;
+    if(!file.open(dataName))
+    {
+        cout<<"ERROR: Can't open file: "<<dataName<<endl;
+        return false;
+    }
+
+    // a window is parsed from the rows given by the index of the log
+    if(start==-HUGE_VAL && end==HUGE_VAL)
+        return parseDumperRows(dataName, file.begin(), file.end(), -HUGE_VAL, start, end, log);
+
+    DumperLogIndex index;
+    if(!index.open(dataName))
+        return false;
+    const DumperLogIndexEntry &first = index.find(start);
+    uint64_t last = min<uint64_t>(index.end(end), file.size());
+    if(first.offset>=last)
+    {
+        cout<<"ERROR: "<<dataName<<" has no samples in the window"<<endl;
+        return false;
+    }
+    return parseDumperRows(dataName, file.begin()+first.offset, file.begin()+last, first.before, start, end, log);
+}
+
+//---------------------------------------------------------
+// all the parts, in parallel
+//---------------------------------------------------------
+class DumperLogLoader : public Thread
+{
+public:
+    DumperLogLoader(const string &directory, const string &part, double start, double end, DumperLog &log)
+        : directory(directory), part(part), windowStart(start), windowEnd(end), log(log), ok(false) {}
+
+    virtual void run()
+    {
+        ok = loadDumperLog(directory, part, windowStart, windowEnd, log);
+    }
+
+    bool succeeded() const { return ok; }
+
+private:
+    string directory;
+    string part;
+    double windowStart, windowEnd;
+    DumperLog &log;
+    bool ok;
+};
+
+bool loadRobotData(const string &directory, vector<DumperLog> &logs, double start, double end)
+{
+    vector<string> parts;
+    for(int k=0; k<nRobotDataParts; k++)
+    {
+        string dataName = directory+"/"+robotDataParts[k].directory+"/data.log";
+        if(access(dataName.c_str(), R_OK)==0)
+            parts.push_back(robotDataParts[k].directory);
+    }
+    if(parts.empty())
+    {
+        cout<<"ERROR: no part found in "<<directory<<endl;
+        return false;
+    }
+
+    logs.clear();
+    logs.resize(parts.size());
+
+    vector<DumperLogLoader *> loaders;
+    for(size_t k=0; k<parts.size(); k++)
+    {
+        loaders.push_back(new DumperLogLoader(directory, parts[k], start, end, logs[k]));
+        loaders.back()->start();
+    }
+
+    // stop() waits for run() to return
+    bool ok=true;
+    for(size_t k=0; k<loaders.size(); k++)
+    {
+        loaders[k]->stop();
+        ok = ok && loaders[k]->succeeded();
+        delete loaders[k];
+    }
+    return ok;
+}
+
+//---------------------------------------------------------
+// alignment on a common time grid
+//---------------------------------------------------------
+static double medianPeriod(const DumperLog &log)
+{
+    vector<double> dt;
+    for(int s=1; s<log.numberOfSamples(); s++)
+        dt.push_back(log.timestamps[s]-log.timestamps[s-1]);
+    if(dt.empty())
+        return 0.0;
+    nth_element(dt.begin(), dt.begin()+dt.size()/2, dt.end());
+    return dt[dt.size()/2];
+}
+
+bool alignRobotData(const vector<DumperLog> &logs, double period,
+                    Vector &time, Matrix &table, vector<string> &names)
+{
+    if(logs.empty())
+        return false;
+
+    // the span covered by all the logs
+    double start=logs[0].timestamps.front();
+    double stop=logs[0].timestamps.back();
+    int nColumns=0;
+    vector<double> periods;
+    for(size_t k=0; k<logs.size(); k++)
+    {
+        start = max(start, logs[k].timestamps.front());
+        stop = min(stop, logs[k].timestamps.back());
+        nColumns += logs[k].nValues;
+        periods.push_back(medianPeriod(logs[k]));
+    }
+    if(period<=0.0)
+    {
+        nth_element(periods.begin(), periods.begin()+periods.size()/2, periods.end());
+        period = periods[periods.size()/2];
+    }
+    if(period<=0.0 || stop<start)
+    {
+        cout<<"ERROR: the logs do not overlap in time"<<endl;
+        return false;
+    }
+
+    int nRows = (int)((stop-start)/period)+1;
+    time.resize(nRows);
+    table.resize(nRows, nColumns);
+    for(int r=0; r<nRows; r++)
+        time[r] = start+r*period;
+
+    names.clear();
+    int column=0;
+    for(size_t k=0; k<logs.size(); k++)
+    {
+        const DumperLog &log = logs[k];
+        for(int v=0; v<log.nValues; v++)
+        {
+            stringstream name;
+            name<<log.part<<"_"<<v;
+            names.push_back(name.str());
+        }
+
+        // the grid and the samples are both in time order: one sweep
+        int s=0;
+        int last=log.numberOfSamples()-1;
+        for(int r=0; r<nRows; r++)
+        {
+            while(s<last-1 && log.timestamps[s+1]<=time[r])
+                s++;
+
+            const double *a = log.sample(s);
+            double *row = table[r]+column;
+            if(s==last)
+            {
+                for(int v=0; v<log.nValues; v++)
+                    row[v] = a[v];
+                continue;
+            }
+            const double *b = log.sample(s+1);
+            double alpha = (time[r]-log.timestamps[s])/(log.timestamps[s+1]-log.timestamps[s]);
+            alpha = max(0.0, min(1.0, alpha));
+            for(int v=0; v<log.nValues; v++)
+                row[v] = a[v]+alpha*(b[v]-a[v]);
+        }
+        column += log.nValues;
+    }
+    return true;
+}
@@ -0,0 +1,76 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#ifndef ROBOT_DATA_H
+#define ROBOT_DATA_H
+
+#include <math.h>
+#include <string>
+#include <vector>
+#include <yarp/sig/Matrix.h>
+#include <yarp/sig/Vector.h>
+
+//---------------------------------------------------------
+// recordings of yarpdatadumper (robot_data/<session>/<part>/)
+// data.log has one row per sample: "seq timestamp v0 v1 ...",
+// info.log has the name of the dumped port
+//---------------------------------------------------------
+
+// the sub-directories written for a whole-body recording, and the
+// control board of each one ("" for the parts that are only sensors)
+struct RobotDataPart
+{
+    const char *directory;
+    const char *robotPart;
+};
+const int nRobotDataParts=7;
+extern const RobotDataPart robotDataParts[nRobotDataParts];
+
+struct DumperLog
+{
+    std::string part;               // sub-directory, e.g. "leftArm"
+    std::string port;               // from info.log, e.g. "/icub/left_arm/state:o"
+    int nValues;                    // values per sample
+    std::vector<int> sequence;
+    std::vector<double> timestamps;
+    std::vector<double> values;     // row-major, nValues per sample
+
+    int numberOfSamples() const { return (int)timestamps.size(); }
+    const double *sample(int s) const { return &values[s*nValues]; }
+};
+
+// read one part of a recording
+bool loadDumperLog(const std::string &directory, const std::string &part, DumperLog &log);
+
+// only the samples with start <= timestamp <= end: the rows are found
+// with the index of data.log (see dumperLogIndex.h), built at the
+// first use, and only those of the window are parsed
+bool loadDumperLog(const std::string &directory, const std::string &part, double start, double end, DumperLog &log);
+
+// read all the parts found in a recording, one thread per part,
+// the whole logs or the window [start, end] of timestamps
+bool loadRobotData(const std::string &directory, std::vector<DumperLog> &logs,
+                   double start=-HUGE_VAL, double end=HUGE_VAL);
+
+// resample all the logs on the grid start, start+period, ... covered by
+// every log (linear interpolation); period<=0 takes the median sampling
+// period of the logs. One row of table per grid time, the values of the
+// logs side by side in the order of logs; names has one entry per column.
+bool alignRobotData(const std::vector<DumperLog> &logs, double period,
+                    yarp::sig::Vector &time, yarp::sig::Matrix &table,
+                    std::vector<std::string> &names);
+
+#endif
@@ -0,0 +1,242 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+
+#include "simulatedControlBoard.h"
+
+#include <cmath>
+#include <iostream>
+#include <mutex>
+#include <yarp/os/Bottle.h>
+#include <yarp/os/Property.h>
+#include <yarp/dev/Drivers.h>
+
+using namespace yarp::os;
+using namespace yarp::dev;
+using namespace std;
+
+// integration step of the servos
+static const double maxStep = 0.001;
+// a movement is done within this distance of its command
+static const double motionDoneTolerance = 0.1;
+
+SimulatedControlBoard::SimulatedControlBoard()
+    : latency(0.0), head(0), count(0), nOverflows(0), last(0.0)
+{
+}
+
+//---------------------------------------------------------
+// the parameters of the servos
+//---------------------------------------------------------
+// "key v0 v1 ..." of a part: one value per joint from the first,
+// the joints after the last value keep theirs
+static bool readJointValues(const Bottle &group, const string &key, int nj, vector<double> &values, const string &filename)
+{
+    Bottle &list = group.findGroup(key);
+    if(list.isNull())
+        return true;
+    if(list.size()<2 || list.size()>nj+1)
+    {
+        cout<<"ERROR: "<<filename<<": "<<key<<" needs 1 to "<<nj<<" values"<<endl;
+        return false;
+    }
+    for(int j=0; j<list.size()-1; j++)
+        values[j] = list.get(j+1).asDouble();
+    return true;
+}
+
+bool SimulatedControlBoard::loadParameters(const string &filename, const string &part)
+{
+    Property config;
+    if(!config.fromConfigFile(filename.c_str()))
+    {
+        cout<<"ERROR: Can't read the servo parameters file: "<<filename<<endl;
+        return false;
+    }
+
+    if(config.check("bandwidth"))
+        bandwidth.assign(nj, config.find("bandwidth").asDouble());
+    if(config.check("maxVelocity"))
+        maxVelocity.assign(nj, config.find("maxVelocity").asDouble());
+    if(config.check("latency"))
+        latency = config.find("latency").asDouble();
+
+    Bottle &group = config.findGroup(part);
+    if(!group.isNull())
+    {
+        if(!readJointValues(group, "bandwidth", nj, bandwidth, filename)
+           || !readJointValues(group, "maxVelocity", nj, maxVelocity, filename))
+            return false;
+        if(group.check("latency"))
+            latency = group.find("latency").asDouble();
+    }
+    return true;
+}
+
+//---------------------------------------------------------
+// DeviceDriver
+//---------------------------------------------------------
+bool SimulatedControlBoard::open(Searchable &config)
+{
+    if(!MockControlBoard::open(config))
+        return false;
+
+    bandwidth.assign(nj, 4.0);
+    maxVelocity.assign(nj, 100.0);
+    latency = 0.01;
+
+    // the part is the end of the remote port, as /icubSim/left_arm
+    string remote = config.find("remote").asString().c_str();
+    string part = remote.substr(remote.find_last_of('/')+1);
+    if(config.check("file") && !loadParameters(config.find("file").asString().c_str(), part))
+        return false;
+
+    if(config.check("bandwidth"))
+        bandwidth.assign(nj, config.find("bandwidth").asDouble());
+    if(config.check("maxVelocity"))
+        maxVelocity.assign(nj, config.find("maxVelocity").asDouble());
+    if(config.check("latency"))
+        latency = config.find("latency").asDouble();
+    int queue = config.check("queue") ? config.find("queue").asInt() : 4096;
+    tau.resize(nj);
+    for(int j=0; j<nj; j++)
+    {
+        if(bandwidth[j]<=0.0 || maxVelocity[j]<=0.0)
+        {
+            cout<<"ERROR: sim_controlboard "<<part<<" joint "<<j<<" needs bandwidth > 0 and maxVelocity > 0"<<endl;
+            return false;
+        }
+        tau[j] = 1.0/(2.0*M_PI*bandwidth[j]);
+    }
+    if(latency<0.0 || queue<=0)
+    {
+        cout<<"ERROR: sim_controlboard needs latency>=0 and queue>0"<<endl;
+        return false;
+    }
+
+    target = q;
+    velocity = maxVelocity;
+    pending.resize(queue);
+    head = 0;
+    count = 0;
+    nOverflows = 0;
+    last = clock->now();
+    return true;
+}
+
+void SimulatedControlBoard::setClock(PlayerClock &clock)
+{
+    lock_guard<Mutex> guard(mutex);
+    while(count>0)
+    {
+        apply(pending[head]);
+        head = (head+1)%pending.size();
+        count--;
+    }
+    MockControlBoard::setClock(clock);
+    last = clock.now();
+}
+
+//---------------------------------------------------------
+// the servos
+//---------------------------------------------------------
+void SimulatedControlBoard::move(int j, int mode, double ref)
+{
+    references[j] = ref;
+
+    SimulatedCommand c;
+    c.time = clock->now()+latency;
+    c.joint = j;
+    c.value = ref;
+    c.velocity = maxVelocity[j];
+    if(mode==VOCAB_CM_POSITION && speeds[j]>0.0 && speeds[j]<c.velocity)
+        c.velocity = speeds[j];
+
+    // the queue is never resized: when it is full the oldest command
+    // reaches its joint early
+    if(count==(int)pending.size())
+    {
+        update();
+        if(count==(int)pending.size())
+        {
+            apply(pending[head]);
+            head = (head+1)%pending.size();
+            count--;
+            nOverflows++;
+        }
+    }
+    pending[(head+count)%pending.size()] = c;
+    count++;
+}
+
+void SimulatedControlBoard::apply(const SimulatedCommand &c)
+{
+    target[c.joint] = c.value;
+    velocity[c.joint] = c.velocity;
+}
+
+void SimulatedControlBoard::integrate(double t)
+{
+    while(last<t)
+    {
+        double h = t-last;
+        if(h>maxStep)
+            h = maxStep;
+        for(int j=0; j<nj; j++)
+        {
+            // exact step of the first order, then the velocity limit
+            double dq = (target[j]-q[j])*(1.0-exp(-h/tau[j]));
+            double dqMax = velocity[j]*h;
+            if(dq>dqMax)
+                dq = dqMax;
+            else if(dq<-dqMax)
+                dq = -dqMax;
+            q[j] += dq;
+        }
+        last = (h==t-last) ? t : last+h;
+    }
+}
+
+void SimulatedControlBoard::update()
+{
+    // the commands that reached their joint, each from its time
+    double now = clock->now();
+    while(count>0 && pending[head].time<=now)
+    {
+        integrate(pending[head].time);
+        apply(pending[head]);
+        head = (head+1)%pending.size();
+        count--;
+    }
+    integrate(now);
+}
+
+bool SimulatedControlBoard::motionDone(int j)
+{
+    return fabs(references[j]-q[j])<=motionDoneTolerance;
+}
+
+//---------------------------------------------------------
+// registration
+//---------------------------------------------------------
+void registerSimulatedControlBoard()
+{
+    static std::once_flag registered;
+    std::call_once(registered, []()
+    {
+        Drivers::factory().add(new DriverCreatorOf<SimulatedControlBoard>("sim_controlboard", "controlboardwrapper2", "SimulatedControlBoard"));
+    });
+}
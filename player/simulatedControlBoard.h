@@ -0,0 +1,89 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+
+#ifndef SIMULATED_CONTROL_BOARD_H
+#define SIMULATED_CONTROL_BOARD_H
+
+#include <string>
+#include <vector>
+#include "mockControlBoard.h"
+
+//---------------------------------------------------------
+// a command waiting for the latency of the board
+//---------------------------------------------------------
+struct SimulatedCommand
+{
+    double time;        // when the joint gets it
+    int joint;
+    double value;
+    double velocity;    // the velocity limit of the movement
+};
+
+//---------------------------------------------------------
+// in-process stand-in for the simulator, device "sim_controlboard":
+// a mock_controlboard (same parameters, commands recorded) whose
+// joints follow the commands as first order servos
+//   tau dq/dt = target - q,  tau = 1/(2 pi bandwidth)
+// with |dq/dt| <= maxVelocity (and <= the reference speed of a
+// positionMove), the commands reaching the joints after latency
+// seconds; the joints are integrated in steps of at most 1 ms up to
+// the time of the clock of the board when they are read
+//   file      servo parameters, the scalars for all the joints then
+//             per part "[part] key v0 v1 ..." (see simulatedControlBoard.ini)
+//   bandwidth Hz (default 4), maxVelocity deg/s (default 100),
+//   latency   s (default 0.01): override the file for all the joints
+//   queue     commands waiting for the latency (default 4096)
+//---------------------------------------------------------
+class SimulatedControlBoard : public MockControlBoard
+{
+public:
+    SimulatedControlBoard();
+
+    virtual bool open(yarp::os::Searchable &config);
+
+    // the joints restart from now() of the new clock, the waiting
+    // commands are applied at once
+    virtual void setClock(PlayerClock &clock);
+
+    // commands applied before their latency because the queue was full
+    long overflows() const { return nOverflows; }
+
+protected:
+    virtual void move(int j, int mode, double ref);
+    virtual void update();
+    virtual bool motionDone(int j);
+
+private:
+    bool loadParameters(const std::string &filename, const std::string &part);
+    void apply(const SimulatedCommand &c);
+    void integrate(double t);
+
+    std::vector<double> bandwidth, maxVelocity;
+    double latency;
+    std::vector<double> tau;
+    std::vector<double> target, velocity;   // the command reached by each joint, and its velocity limit
+
+    std::vector<SimulatedCommand> pending;  // ring allocated at open, in time order
+    int head, count;
+    long nOverflows;
+    double last;                            // the joints are integrated up to last
+};
+
+// make "sim_controlboard" known to PolyDriver (once per process)
+void registerSimulatedControlBoard();
+
+#endif
@@ -0,0 +1,193 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+
+#include "telemetryRecorder.h"
+
+#include <stddef.h>
+#include <string.h>
+#include <iostream>
+#include <yarp/os/Time.h>
+
+using namespace yarp::os;
+using namespace std;
+
+// the header is written as is
+typedef char telemetryHeaderSizeCheck[sizeof(TelemetryHeader)==64 ? 1 : -1];
+
+static const uint64_t telemetryAlign = 64;
+
+static uint64_t alignUp(uint64_t n)
+{
+    return (n+telemetryAlign-1)/telemetryAlign*telemetryAlign;
+}
+
+TelemetryRecorder::TelemetryRecorder(int periodMs)
+    : RateThread(periodMs), file(0), withEncoders(false), waitWhenFull(false), recordSize(0), capacity(0),
+      head(0), tail(0), dropped(0), written(0), failed(false)
+{
+}
+
+TelemetryRecorder::~TelemetryRecorder()
+{
+    close();
+}
+
+bool TelemetryRecorder::open(const string &name, double rate, bool encoders, int size, bool wait)
+{
+    close();
+    if(size<=0)
+    {
+        cout<<"ERROR: the telemetry needs a capacity > 0"<<endl;
+        return false;
+    }
+
+    filename = name;
+    withEncoders = encoders;
+    waitWhenFull = wait;
+    recordSize = sizeof(TelemetryRecordHeader)+nBodyJoints*sizeof(double)*(withEncoders ? 2 : 1);
+    capacity = size;
+    ring.assign((size_t)capacity*recordSize, 0);
+    head.store(0);
+    tail.store(0);
+    dropped.store(0);
+    written = 0;
+    failed = false;
+
+    // the iCub names: joint j of a part is column j of the dumper log of the part
+    vector<string> names(bodyJointNames, bodyJointNames+nBodyJoints);
+    uint64_t namesSize = 0;
+    for(size_t j=0; j<names.size(); j++)
+        namesSize += names[j].size()+1;
+
+    TelemetryHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TELEMETRY_MAGIC, 8);
+    header.version = TELEMETRY_VERSION;
+    header.nJoints = nBodyJoints;
+    header.nRecords = 0;
+    header.rate = rate;
+    header.namesOffset = sizeof(header);
+    header.dataOffset = alignUp(sizeof(header)+namesSize);
+    header.recordSize = (uint32_t)recordSize;
+    header.flags = withEncoders ? TELEMETRY_HAS_ENCODERS : 0;
+
+    file = fopen(filename.c_str(), "wb");
+    if(!file)
+    {
+        cout<<"ERROR: Can't write the telemetry file: "<<filename<<endl;
+        return false;
+    }
+    static const char zeros[telemetryAlign] = {0};
+    bool ok = fwrite(&header, sizeof(header), 1, file)==1;
+    for(size_t j=0; ok && j<names.size(); j++)
+        ok = fwrite(names[j].c_str(), names[j].size()+1, 1, file)==1;
+    uint64_t pad = header.dataOffset-sizeof(header)-namesSize;
+    if(ok && pad>0)
+        ok = fwrite(zeros, pad, 1, file)==1;
+    if(!ok || !start())
+    {
+        cout<<"ERROR: while starting the telemetry "<<filename<<endl;
+        fclose(file);
+        file = 0;
+        return false;
+    }
+    return true;
+}
+
+//---------------------------------------------------------
+// the loop side: a copy, no I/O and no allocation
+//---------------------------------------------------------
+void TelemetryRecorder::record(double time, int tick, int frame, const double *command, const EncoderSnapshot *snapshot)
+{
+    if(!file)
+        return;
+    long h = head.load(std::memory_order_relaxed);
+    while(h-tail.load(std::memory_order_acquire)>=capacity)
+    {
+        if(!waitWhenFull)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        Time::delay(0.001);
+    }
+
+    unsigned char *r = &ring[(size_t)(h%capacity)*recordSize];
+    TelemetryRecordHeader header;
+    header.time = time;
+    header.encodersTime = snapshot ? snapshot->stamp : 0.0;
+    header.tick = tick;
+    header.frame = frame;
+    memcpy(r, &header, sizeof(header));
+    memcpy(r+sizeof(header), command, nBodyJoints*sizeof(double));
+    if(withEncoders)
+    {
+        double *q = reinterpret_cast<double *>(r+sizeof(header))+nBodyJoints;
+        if(snapshot)
+            memcpy(q, snapshot->q, nBodyJoints*sizeof(double));
+        else
+            memset(q, 0, nBodyJoints*sizeof(double));
+    }
+    head.store(h+1, std::memory_order_release);
+}
+
+//---------------------------------------------------------
+// the writer side
+//---------------------------------------------------------
+bool TelemetryRecorder::flush()
+{
+    long h = head.load(std::memory_order_acquire);
+    long t = tail.load(std::memory_order_relaxed);
+    while(t<h)
+    {
+        // up to the end of the ring at once
+        long n = min(h-t, capacity-t%capacity);
+        if(!failed && fwrite(&ring[(size_t)(t%capacity)*recordSize], recordSize, n, file)!=(size_t)n)
+        {
+            cout<<"ERROR: while writing the telemetry "<<filename<<", the next records are lost"<<endl;
+            failed = true;
+        }
+        if(!failed)
+            written += n;
+        t += n;
+        tail.store(t, std::memory_order_release);
+    }
+    return !failed;
+}
+
+void TelemetryRecorder::run()
+{
+    flush();
+}
+
+bool TelemetryRecorder::close()
+{
+    if(!file)
+        return true;
+    if(isRunning())
+        stop();
+    bool ok = flush();
+
+    // the number of records, now that it is known
+    uint64_t nRecords = written;
+    ok = ok && fseek(file, offsetof(TelemetryHeader, nRecords), SEEK_SET)==0 && fwrite(&nRecords, sizeof(nRecords), 1, file)==1;
+    ok = (fclose(file)==0) && ok;
+    if(!ok)
+        cout<<"ERROR: while closing the telemetry "<<filename<<endl;
+    file = 0;
+    return ok;
+}
@@ -0,0 +1,116 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+
+#ifndef TELEMETRY_RECORDER_H
+#define TELEMETRY_RECORDER_H
+
+#include <atomic>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <yarp/os/RateThread.h>
+#include "wholeBodyTrajectory.h"
+#include "encoderReader.h"
+
+//---------------------------------------------------------
+// telemetry file of a playback, little endian:
+//   header (64 bytes)
+//   joint names, each one '\0' terminated, padded to 64 bytes
+//   nRecords records of recordSize bytes from dataOffset:
+//     TelemetryRecordHeader
+//     nJoints float64, the command
+//     nJoints float64, the latest encoders (if HAS_ENCODERS)
+// nRecords is written when the file is closed: after a crash it is
+// 0 and the records are the ones that fit in the file
+//---------------------------------------------------------
+#define TELEMETRY_MAGIC "ICUBTELE"
+#define TELEMETRY_VERSION 1
+#define TELEMETRY_HAS_ENCODERS 1
+
+struct TelemetryHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t nJoints;
+    uint64_t nRecords;
+    double rate;            // Hz, of the ticks
+    uint64_t namesOffset;   // bytes from the start of the file
+    uint64_t dataOffset;
+    uint32_t recordSize;    // bytes
+    uint32_t flags;
+    uint8_t reserved[8];
+};
+
+struct TelemetryRecordHeader
+{
+    double time;            // s, of the clock of the player when the command was sent
+    double encodersTime;    // s, stamp of the encoders, 0 if there are none yet
+    int32_t tick;
+    int32_t frame;          // of the trajectory
+};
+
+//---------------------------------------------------------
+// records every command of the playing loop, and optionally the
+// latest encoders, in a ring allocated by open(); a thread writes
+// the ring to the file every periodMs, so that the loop does no I/O.
+// When the ring is full the records are dropped and counted, or the
+// loop waits for the writer if waitWhenFull (virtual clock).
+//---------------------------------------------------------
+class TelemetryRecorder : public yarp::os::RateThread
+{
+public:
+    TelemetryRecorder(int periodMs=50);
+    ~TelemetryRecorder();
+
+    // the played joints of a frame, with their iCub names (bodyJointNames); capacity records in the ring
+    bool open(const std::string &filename, double rate, bool withEncoders, int capacity=8192, bool waitWhenFull=false);
+
+    // the loop: copy one record to the ring, from one thread only;
+    // snapshot can be 0
+    void record(double time, int tick, int frame, const double *command, const EncoderSnapshot *snapshot);
+
+    // write the rest, the number of records, and close the file
+    bool close();
+
+    long numberOfRecords() const { return written; }
+    long droppedRecords() const { return dropped.load(std::memory_order_relaxed); }
+
+protected:
+    virtual void run();
+
+private:
+    TelemetryRecorder(const TelemetryRecorder &);
+    TelemetryRecorder &operator=(const TelemetryRecorder &);
+
+    bool flush();
+
+    std::string filename;
+    FILE *file;
+    bool withEncoders;
+    bool waitWhenFull;
+    size_t recordSize;
+    int capacity;
+    std::vector<unsigned char> ring;    // capacity records, never reallocated
+    std::atomic<long> head;             // records put by the loop
+    std::atomic<long> tail;             // records taken by the writer
+    std::atomic<long> dropped;
+    long written;
+    bool failed;
+};
+
+#endif
@@ -0,0 +1,947 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#include "trajectoryPlayer.h"
+#include "jointMapping.h"
+#include "simulatedControlBoard.h"
+#include "playerControl.h"
+#include "latencyHistogram.h"
+#include "telemetryRecorder.h"
+#include "robotData.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <iostream>
+#include <new>
+#include <yarp/os/Thread.h>
+#include <yarp/os/Time.h>
+
+using namespace yarp::os;
+using namespace yarp::dev;
+using namespace yarp::sig;
+using namespace std;
+
+static const int nJointsArm=7;
+static const int nJointsTorso=3;
+static const int nJointsLegs=6;
+
+//---------------------------------------------------------
+// retarget the human data on the whole-body trajectory
+// the joints without human data keep the encoders values
+//---------------------------------------------------------
+bool loadHumanDataOnRobotTrajectory(const HumanData &human,
+                                    Vector &q_RA, Vector &q_LA, Vector &q_T, Vector &q_RL, Vector &q_LL,
+                                    WholeBodyTrajectory &traj)
+{
+
+    int nbIter = human.numberOfFrames();
+
+    if(nbIter<1)
+    {
+        cout<<"Apparently there is no loaded trajectory... keeping the current point"<<endl;
+        return false;
+    }
+
+    if(!traj.resize(nbIter))
+    {
+        cout<<"Cannot allocate a trajectory of "<<nbIter<<" frames"<<endl;
+        return false;
+    }
+
+    // the encoders, once, in the layout of a frame
+    double encoders[nBodyJoints];
+    for(int j=0; j<nJointsArm; j++)
+    {
+        encoders[bodyPartOffset[RIGHT_ARM]+j]=q_RA[j];
+        encoders[bodyPartOffset[LEFT_ARM]+j]=q_LA[j];
+    }
+    for(int j=0; j<nJointsTorso; j++)
+        encoders[bodyPartOffset[TORSO]+j]=q_T[j];
+    for(int j=0; j<nJointsLegs; j++)
+    {
+        encoders[bodyPartOffset[RIGHT_LEG]+j]=q_RL[j];
+        encoders[bodyPartOffset[LEFT_LEG]+j]=q_LL[j];
+    }
+
+    for (int c=0; c<nbIter; c++)
+    {
+        //first copy the encoders, then change the joints from the human data
+        memcpy(traj.frame(c), encoders, sizeof(encoders));
+        retargetFrame(human, c, traj.frame(c));
+    }
+
+    return true;
+
+
+}
+
+
+//---------------------------------------------------------
+// the parts of a recording on the whole-body trajectory
+// the parts not recorded keep the encoders values
+//---------------------------------------------------------
+bool loadRecordingOnRobotTrajectory(const Matrix &recording, const int column[nBodyParts],
+                                    const Vector encoders[nBodyParts],
+                                    WholeBodyTrajectory &traj)
+{
+    int nbIter = recording.rows();
+
+    if(nbIter<1)
+    {
+        cout<<"Apparently there is no loaded recording... keeping the current point"<<endl;
+        return false;
+    }
+
+    if(!traj.resize(nbIter))
+    {
+        cout<<"Cannot allocate a trajectory of "<<nbIter<<" frames"<<endl;
+        return false;
+    }
+
+    for(int c=0; c<nbIter; c++)
+        for(int p=0; p<nBodyParts; p++)
+        {
+            const double *values = (column[p]<0 ? encoders[p].data() : recording[c]+column[p]);
+            memcpy(traj.part(c,(BodyPart)p), values, bodyPartSize[p]*sizeof(double));
+        }
+
+    return true;
+}
+
+
+
+//---------------------------------------------------------
+// check the safety of a posture (within the joint limits)
+//---------------------------------------------------------
+int safety_check(const JointLimits &limits, double *command_RA, double *command_LA, double *command_T, double *command_RL, double *command_LL)
+{
+    int violations=0;
+    double *command[nBodyParts] = { command_RA, command_LA, command_T, command_RL, command_LL };
+
+    for(int p=0; p<nBodyParts; p++)
+        for(int i=0; i<bodyPartSize[p]; i++)
+        {
+            double max = limits.partMax((BodyPart)p)[i];
+            double min = limits.partMin((BodyPart)p)[i];
+            if(command[p][i]>max) {  command[p][i]=max; cout<<"#### max "<<bodyPartNames[p]<<" "<<i<<endl; violations++;}
+            if(command[p][i]<min) {  command[p][i]=min; cout<<"#### min "<<bodyPartNames[p]<<" "<<i<<endl; violations++;}
+        }
+
+    return violations;
+}
+
+//---------------------------------------------------------
+// minimum-jerk movement of the played joints from the encoders to a
+// frame, streamed to all the parts together in direct mode (the joints
+// that refuse it get positionMove); it is done when the encoders are
+// within tolerance of the frame and the position joints are stopped.
+// With a virtual clock the encoders are polled here.
+//---------------------------------------------------------
+static bool approachFrame(PlayerPart player[nBodyParts], EncoderReader &encoders, PlayerClock &clock, const double *target,
+                          double speed, double directRate, double tolerance, double timeout, int verbosity)
+{
+    bool poll=clock.isVirtual();
+    EncoderSnapshot from;
+    if(poll)
+        encoders.poll();
+    if(!encoders.latest(from))
+    {
+        cout<<"Error: no encoders to start the approach from"<<endl;
+        return false;
+    }
+
+    // the peak velocity of a minimum-jerk movement is 1.875 times its mean velocity
+    double distance=0.0;
+    for(int j=0; j<nBodyJoints; j++)
+        distance=max(distance, fabs(target[j]-from.q[j]));
+    double duration=max(1.0, 1.875*distance/speed);
+    if(verbosity>=1) cout<<"Approach of "<<distance<<" deg in "<<duration<<" s"<<endl;
+
+    for(int p=0; p<nBodyParts; p++)
+        player[p].allDirect = setDirectMode(player[p].ictrl, bodyPartSize[p], bodyPartNames[p], player[p].direct)==0;
+
+    double start=clock.now();
+    int nTicks=(int)ceil(duration*directRate);
+    alignas(64) double command[WholeBodyTrajectory::frameStride];
+    PartDispatcher dispatcher(player, true);
+    PeriodicScheduler scheduler(1.0/directRate, OVERRUN_SKIP, clock);
+    scheduler.start();
+    for(int k=scheduler.waitNextTick(); k<=nTicks; k=scheduler.waitNextTick())
+    {
+        double s=(double)k/nTicks;
+        double alpha=s*s*s*(10.0-15.0*s+6.0*s*s);
+        for(int j=0; j<nBodyJoints; j++)
+            command[j]=from.q[j]+alpha*(target[j]-from.q[j]);
+        dispatcher.send(command);
+    }
+
+    // no fixed wait: the joints are polled until they are all there
+    double error=0.0;
+    bool done=false;
+    double end=clock.now()+timeout;
+    while(!done && clock.now()<end)
+    {
+        clock.delay(0.02);
+        EncoderSnapshot now;
+        if(poll)
+            encoders.poll();
+        encoders.latest(now);
+        error=0.0;
+        for(int j=0; j<nBodyJoints; j++)
+            error=max(error, fabs(target[j]-now.q[j]));
+        done=(error<=tolerance);
+        for(int p=0; p<nBodyParts && done; p++)
+        {
+            for(int j=0; j<bodyPartSize[p] && done; j++)
+            {
+                bool motionDone=true;
+                if(!player[p].direct[j] && player[p].pos->checkMotionDone(j, &motionDone))
+                    done=motionDone;
+            }
+        }
+    }
+
+    if(verbosity>=1) cout<<"Approach "<<(done ? "done" : "NOT done")<<" in "<<clock.now()-start<<" s, worst error "<<error<<" deg"<<endl;
+    return done;
+}
+
+//---------------------------------------------------------
+// the playing loop: one tick per frame (or per substep), on absolute
+// deadlines, so that the playing time is the one of the capture
+// whatever is spent in sending the commands. With an rpc port, the
+// playhead can be paused, moved and sped up between two ticks.
+//---------------------------------------------------------
+struct Playback
+{
+    const WholeBodyTrajectory *trajectory;
+    PartDispatcher *dispatcher;
+    PeriodicScheduler *scheduler;
+    int first;      // starting frame
+    int substeps;   // ticks per frame, the frames are interpolated in between
+    bool progress;  // print the frame being played
+    EncoderReader *encoders;        // the tracking error is measured if not null
+    bool pollEncoders;              // virtual clock: the encoders are read by the loop
+    TrackingMonitor *tracking;
+    PlayerCommandQueue *commands;   // rpc commands, if not null; the end is then held until stop
+    PlayerStatus *status;
+    double seekSpeed;   // deg/s, mean velocity of the movement to a seeked frame
+    const JointLimits *limits;      // every command is saturated to them
+    LoopTiming *timing;
+    bool measurePeriod;             // system clock: the ticks are timed
+    int saturatedCommands;          // out, commands that were outside the limits
+    PlayerClock *clock;
+    TelemetryRecorder *telemetry;   // every command (and encoders) recorded if not null
+};
+
+static void playTrajectory(Playback &play)
+{
+    const WholeBodyTrajectory &trajectory = *play.trajectory;
+    int nFrames = trajectory.numberOfFrames();
+    int substeps = play.substeps;
+    int end = nFrames*substeps;
+    alignas(64) double command[WholeBodyTrajectory::frameStride];
+    alignas(64) double seekFrom[WholeBodyTrajectory::frameStride];
+    EncoderSnapshot snapshot;
+
+    // playhead in ticks, advanced by speed ticks per tick
+    double position=play.first*substeps;
+    double speed=1.0;
+    bool paused=false;
+    bool stopped=false;
+    int seekTicks=0, seekTick=0;    // movement to a seeked frame
+    const double *seekTo=0;
+    int lastPrinted=-1;
+    for(int j=0; j<WholeBodyTrajectory::frameStride; j++)
+        command[j]=trajectory.frame(play.first)[j];
+    LoopTiming &timing = *play.timing;
+    double tickStart=0.0;
+    play.saturatedCommands=0;
+
+    // everything is allocated: nothing should be from here
+    NoAllocationScope loop;
+
+    play.scheduler->start(play.first*substeps);
+    int previous=play.first*substeps;
+    for(int k=play.scheduler->waitNextTick(); !stopped; k=play.scheduler->waitNextTick())
+    {
+        // the error on the interval from the previous tick, skipped ones included
+        if(play.measurePeriod)
+        {
+            double now=monotonicTime();
+            if(k>play.first*substeps)
+                timing.period.record(fabs(now-tickStart-(k-previous)*play.scheduler->period()));
+            tickStart=now;
+        }
+
+        // with the skip policy the overrun ticks are not played, but the
+        // playhead stays on time
+        if(!paused && seekTicks==0)
+            position+=speed*(k-previous);
+        previous=k;
+
+        PlayerCommand c;
+        while(play.commands && play.commands->pop(c))
+        {
+            switch(c.type)
+            {
+            case PLAYER_PAUSE:  paused=true; break;
+            case PLAYER_RESUME: paused=false; break;
+            case PLAYER_SPEED:  speed=c.value; break;
+            case PLAYER_STOP:   stopped=true; break;
+            case PLAYER_SEEK:
+                {
+                    // from where the joints are commanded now
+                    position=c.value*substeps;
+                    seekTo=trajectory.frame((int)c.value);
+                    double distance=0.0;
+                    for(int j=0; j<nBodyJoints; j++)
+                        distance=max(distance, fabs(seekTo[j]-command[j]));
+                    for(int j=0; j<nBodyJoints; j++)
+                        seekFrom[j]=command[j];
+                    seekTicks=(int)ceil(max(0.5, 1.875*distance/play.seekSpeed)/play.scheduler->period());
+                    seekTick=0;
+                }
+                break;
+            }
+        }
+        if(stopped)
+            break;
+
+        if(position>=end)
+        {
+            if(!play.commands)
+                break;
+            // hold the last frame until the next command
+            position=end-substeps;
+            paused=true;
+        }
+
+        int t=(int)position/substeps;
+        if(seekTicks>0)
+        {
+            double s=(double)(++seekTick)/seekTicks;
+            double alpha=s*s*s*(10.0-15.0*s+6.0*s*s);
+            for(int j=0; j<nBodyJoints; j++)
+                command[j]=seekFrom[j]+alpha*(seekTo[j]-seekFrom[j]);
+            if(seekTick==seekTicks)
+                seekTicks=0;
+        }
+        else
+        {
+            const double *frame=trajectory.frame(t);
+            const double *next=trajectory.frame(min(t+1, nFrames-1));
+            double alpha=(position-t*substeps)/substeps;
+            for(int j=0; j<nBodyJoints; j++)
+                command[j]=frame[j]+alpha*(next[j]-frame[j]);
+        }
+
+        // the frames are already within the limits (checkJointLimits), and
+        // so is a point between two frames: this only guards the loop
+        double checkStart=monotonicTime();
+        if(saturateFrame(command, *play.limits))
+            play.saturatedCommands++;
+        timing.safety.record(monotonicTime()-checkStart);
+
+        play.dispatcher->send(command);
+        for(int p=0; p<nBodyParts; p++)
+            timing.send[p].record(play.dispatcher->sendDuration((BodyPart)p));
+
+        // the latest encoders, there is no waiting for them
+        if(play.encoders && play.pollEncoders)
+            play.encoders->poll();
+        bool measured = play.encoders && play.encoders->latest(snapshot);
+        if(measured)
+            play.tracking->update(command, snapshot);
+
+        if(play.telemetry)
+            play.telemetry->record(play.clock->now(), k, t, command, measured ? &snapshot : 0);
+
+        if(play.status)
+        {
+            play.status->frame=t;
+            play.status->paused=paused;
+            play.status->speed=speed;
+        }
+
+        if(play.progress && t!=lastPrinted)
+        {
+            printf ("Moving : \r%d / %d  - tracking error %.2f deg   ", t, nFrames, play.tracking->latestWorst());
+            lastPrinted=t;
+        }
+    }
+}
+
+// the same in a real-time thread
+class PlaybackThread : public Thread
+{
+public:
+    PlaybackThread(Playback &play, const RealTimeOptions &realTime) : play(play), realTime(realTime) {}
+
+    virtual bool threadInit()
+    {
+        makeThreadRealTime(realTime.priority, realTime.cpus);
+        return true;
+    }
+
+    virtual void run()
+    {
+        playTrajectory(play);
+    }
+
+private:
+    Playback &play;
+    RealTimeOptions realTime;
+};
+
+
+//---------------------------------------------------------
+// TrajectoryPlayer
+//---------------------------------------------------------
+TrajectoryPlayerOptions::TrajectoryPlayerOptions()
+    : robot("icubGazeboSim"), name("/upperBodyPlayer"), device("remote_controlboard"), virtualClock(false),
+      verbosity(2), first(0), rate(10.0), recordingRate(0.0), directRate(100.0), overrunPolicy(OVERRUN_SKIP), directMode(false),
+      concurrentDispatch(true), driversTimeout(10.0), driversRetries(2), approachSpeed(10.0), telemetryEncoders(false)
+{
+}
+
+TrajectoryPlayer::TrajectoryPlayer(const TrajectoryPlayerOptions &options)
+    : opt(options), clock(options.virtualClock ? &virtualClock : &systemClock()),
+      rate(0.0), nFrames(0), opened(false), encoderReader(0), encodersRunning(false), approached(false)
+{
+    defaultJointLimits(limits);
+    for(int p=0; p<nBodyParts; p++)
+    {
+        recordingColumn[p]=-1;
+        drivers[p].dd=0;
+        drivers[p].ok=false;
+    }
+}
+
+TrajectoryPlayer::~TrajectoryPlayer()
+{
+    close();
+}
+
+bool TrajectoryPlayer::loadLimits(const string &name)
+{
+    limitsName=name;
+    if(limitsName!="robot" && !loadJointLimits(limitsName, limits))
+    {
+        cout<<"Errors in loading the joint limits. Closing."<<endl;
+        return false;
+    }
+    return true;
+}
+
+bool TrajectoryPlayer::load(const string &filename)
+{
+    struct stat fileStat;
+    if(stat(filename.c_str(), &fileStat)==0 && S_ISDIR(fileStat.st_mode))
+    {
+        if(opt.verbosity>=1) cout<<"==> "<<filename<<" is a directory, playing it as a robot recording"<<endl;
+        if(!loadRecording(filename))
+        {
+            cout<<"Errors in loading the recording "<<filename<<". Closing."<<endl;
+            return false;
+        }
+    }
+    else
+    {
+        if(!loadHumanData(filename, opt.rate, human))
+        {
+            cout<<"Errors in loading the trajectory file of the human data. Closing."<<endl;
+            return false;
+        }
+
+        // the text files are played at rate, the others at their own rate
+        if(human.rate<=0.0)
+            human.rate = opt.rate;
+        rate = human.rate;
+        nFrames = human.numberOfFrames();
+        recording.resize(0,0);
+    }
+    if(opt.verbosity>=1) cout<<"Playing "<<nFrames<<" frames at "<<rate<<" Hz"<<endl;
+
+    if(opt.first>=nFrames)
+    {
+        cout<<"Starting point is after the end of the trajectory. Please choose a starting point smaller than "<<nFrames<<endl;
+        return false;
+    }
+    return true;
+}
+
+bool TrajectoryPlayer::loadRecording(const string &directory)
+{
+    vector<DumperLog> all;
+    if(!loadRobotData(directory, all))
+        return false;
+
+    // only the played parts, the first joints of each (not the hands)
+    vector<DumperLog> logs;
+    vector<bool> played(all.size(), false);
+    for(int p=0; p<nBodyParts; p++)
+    {
+        recordingColumn[p]=-1;
+        for(size_t k=0; k<all.size(); k++)
+            for(int d=0; d<nRobotDataParts; d++)
+                if(all[k].part==robotDataParts[d].directory && string(robotDataParts[d].robotPart)==bodyPartNames[p])
+                {
+                    if(all[k].nValues<bodyPartSize[p])
+                    {
+                        cout<<"ERROR: "<<bodyPartNames[p]<<" has "<<all[k].nValues<<" values recorded, "<<bodyPartSize[p]<<" are played"<<endl;
+                        return false;
+                    }
+                    recordingColumn[p]=(int)logs.size();
+                    logs.push_back(all[k]);
+                    played[k]=true;
+                }
+        if(recordingColumn[p]<0 && opt.verbosity>=1)
+            cout<<"Warning: "<<bodyPartNames[p]<<" is not in the recording, it keeps its encoders"<<endl;
+    }
+    for(size_t k=0; k<all.size(); k++)
+        if(!played[k])
+            cout<<"Warning: "<<all[k].part<<" is in the recording but is not a played part, it is ignored"<<endl;
+    if(logs.empty())
+    {
+        cout<<"ERROR: none of the played parts is in "<<directory<<endl;
+        return false;
+    }
+
+    // at the median period of the recording, resampled only at the
+    // rate asked for
+    Vector time;
+    vector<string> names;
+    if(!alignRobotData(logs, opt.recordingRate>0.0 ? 1.0/opt.recordingRate : 0.0, time, recording, names))
+        return false;
+    if(time.size()<2)
+    {
+        cout<<"ERROR: the parts of "<<directory<<" overlap on less than two samples"<<endl;
+        return false;
+    }
+    rate = 1.0/(time[1]-time[0]);
+    nFrames = recording.rows();
+
+    // from the index of the log to the first column of its part
+    int columns[nBodyParts+1];
+    columns[0]=0;
+    for(size_t k=0; k<logs.size(); k++)
+        columns[k+1]=columns[k]+logs[k].nValues;
+    for(int p=0; p<nBodyParts; p++)
+        if(recordingColumn[p]>=0)
+            recordingColumn[p]=columns[recordingColumn[p]];
+    return true;
+}
+
+bool TrajectoryPlayer::open()
+{
+    // a robot cannot wait for a virtual clock
+    if(opt.virtualClock && opt.device=="remote_controlboard")
+    {
+        cout<<"ERROR: the virtual clock needs in-process parts (mock_controlboard, sim_controlboard)"<<endl;
+        return false;
+    }
+    if(opt.device=="mock_controlboard")
+        registerMockControlBoard();
+    if(opt.device=="sim_controlboard")
+        registerSimulatedControlBoard();
+    if(!opt.deviceFile.empty())
+        for(int p=0; p<nBodyParts; p++)
+            drivers[p].options.put("file",opt.deviceFile.c_str());
+    // the in-process boards record the commands of one playing: the
+    // played joints at every tick (frames interpolated in direct mode)
+    if(opt.device!="remote_controlboard" && nFrames>0)
+    {
+        int ticks=nFrames;
+        if(opt.directMode && rate<opt.directRate)
+            ticks*=(int)ceil(opt.directRate/rate);
+        for(int p=0; p<nBodyParts; p++)
+            drivers[p].options.put("capacity",ticks*bodyPartSize[p]);
+    }
+
+    // the compliance is only on the real robot
+    if(!openPartDrivers(opt.robot, opt.name, opt.device, opt.robot=="icub", opt.driversTimeout, opt.driversRetries, drivers, opt.verbosity))
+    {
+        // the parts that did not answer close their driver when they end
+        for(int p=0; p<nBodyParts; p++)
+        {
+            if(drivers[p].ok) delete drivers[p].dd;
+            drivers[p].dd=0;
+        }
+        return false;
+    }
+    opened=true;
+
+    // the mock boards (and the simulated ones) stamp the commands and
+    // move the joints on the playing time
+    for(int p=0; p<nBodyParts; p++)
+    {
+        MockControlBoard *mock=0;
+        if(drivers[p].dd->view(mock))
+            mock->setClock(*clock);
+    }
+
+    if(opt.verbosity>=1) cout<< " ***** EVERYTHING IS CREATED ****** "<<endl;
+
+    //---------------  JOINT LIMITS FROM THE ROBOT  --------------
+
+    if(limitsName=="robot")
+    {
+        bool ok=true;
+        for(int p=0; p<nBodyParts && ok; p++)
+        {
+            IControlLimits *ilim=0;
+            ok = drivers[p].dd->view(ilim) && readJointLimits(ilim, (BodyPart)p, limits);
+        }
+        if(!ok)
+        {
+            cout<<"Errors in reading the joint limits from the robot. Closing."<<endl;
+            close();
+            return false;
+        }
+    }
+
+    if(opt.verbosity>=1)
+        cout<<"nj arms / torso / legs "<<drivers[RIGHT_ARM].encoders.size()<<" / "<<drivers[TORSO].encoders.size()
+            <<" / "<<drivers[RIGHT_LEG].encoders.size()<<endl;
+
+    // accelerations and velocities of the position mode
+    for(int p=0; p<nBodyParts; p++)
+    {
+        int nj=(int)drivers[p].encoders.size();
+        Vector accelerations(nj);
+        for(int j=0; j<nj; j++)
+            accelerations[j]=50.0;
+        drivers[p].pos->setRefAccelerations(accelerations.data());
+        for(int j=0; j<nj; j++)
+            drivers[p].pos->setRefSpeed(j, 5.0);
+    }
+
+    // the initial configuration of the limbs, read when the drivers were opened
+    if(opt.verbosity>=1)
+        cout<<"Encoders right arm "<<drivers[RIGHT_ARM].encoders.toString()<<endl
+            <<"Encoders left arm "<<drivers[LEFT_ARM].encoders.toString()<<endl
+            <<"Encoders torso "<<drivers[TORSO].encoders.toString()<<endl
+            <<"Encoders right leg "<<drivers[RIGHT_LEG].encoders.toString()<<endl
+            <<"Encoders left leg "<<drivers[LEFT_LEG].encoders.toString()<<endl;
+    return true;
+}
+
+bool TrajectoryPlayer::retarget()
+{
+    if(!opened)
+    {
+        cout<<"ERROR: the drivers must be opened before the retargeting"<<endl;
+        return false;
+    }
+    if(recording.rows()>0)
+    {
+        Vector encoders[nBodyParts];
+        for(int p=0; p<nBodyParts; p++)
+            encoders[p]=drivers[p].encoders;
+        return loadRecordingOnRobotTrajectory(recording, recordingColumn, encoders, traj);
+    }
+    return loadHumanDataOnRobotTrajectory(human, drivers[RIGHT_ARM].encoders, drivers[LEFT_ARM].encoders, drivers[TORSO].encoders,
+                                          drivers[RIGHT_LEG].encoders, drivers[LEFT_LEG].encoders, traj);
+}
+
+int TrajectoryPlayer::check()
+{
+    // the starting point: only the joints from the human data are
+    // changed, the others are fixed
+    for(int p=0; p<nBodyParts; p++)
+    {
+        command[p]=drivers[p].encoders;
+        for(int j=0; j<bodyPartSize[p]; j++)
+            command[p][j]=traj.part(opt.first,(BodyPart)p)[j];
+    }
+
+    int violations = safety_check(limits, command[RIGHT_ARM].data(), command[LEFT_ARM].data(), command[TORSO].data(),
+                                  command[RIGHT_LEG].data(), command[LEFT_LEG].data());
+
+    if(violations==0)
+        cout<<" *** FEASIBLE STARTING POSITION *** "<<endl;
+    else
+        cout<<" *** INFEASIBLE STARTING POSITION *** "<<endl
+            <<"\nThe initial position violates the joint limits x"<<violations<<" times"<<endl
+            <<"WE WILL CHANGE THE VALUES"<<endl;
+
+    // the whole trajectory is checked (and saturated) here once,
+    // so that nothing is left to do in the playing loop
+    if(checkJointLimits(traj, opt.first, limits, limitsReport)==0)
+        cout<<" *** FEASIBLE TRAJECTORY *** "<<endl;
+    else
+    {
+        cout<<" *** INFEASIBLE TRAJECTORY *** "<<endl;
+        printJointLimitsReport(limitsReport);
+        cout<<"THE JOINTS WILL BE SATURATED"<<endl;
+    }
+    return violations;
+}
+
+bool TrajectoryPlayer::approach()
+{
+    approached=false;
+    for(int p=0; p<nBodyParts; p++)
+    {
+        player[p].pos=drivers[p].pos;
+        player[p].posd=drivers[p].posd;
+        player[p].ictrl=drivers[p].ictrl;
+        player[p].allDirect=false;
+    }
+
+    // the encoders are read in the background from now on
+    if(!encoderReader)
+    {
+        IEncoders *encs[nBodyParts];
+        for(int p=0; p<nBodyParts; p++)
+            encs[p]=drivers[p].encs;
+        encoderReader=new (encoderReaderStorage) EncoderReader(encs, 5, *clock);
+        if(clock->isVirtual())
+            encodersRunning = encoderReader->poll();
+        else
+            encodersRunning = encoderReader->start() && encoderReader->waitFirst(1.0);
+    }
+
+    // all the parts together to the starting frame
+    if(!encodersRunning || !approachFrame(player, *encoderReader, *clock, traj.frame(opt.first), opt.approachSpeed, opt.directRate, 1.0, 5.0, opt.verbosity))
+    {
+        cout<<"Warning: the robot is not in the initial position"<<endl;
+        return false;
+    }
+    approached=true;
+    return true;
+}
+
+bool TrajectoryPlayer::play()
+{
+    // from anywhere else the first frame would be a step
+    if(!approached)
+    {
+        cout<<"ERROR: the robot must be brought to the starting frame before playing"<<endl;
+        return false;
+    }
+    approached=false;
+
+    cout<<"******  MOVING! ****** "<<endl;
+
+    // the in-process boards record the playing only, not the approach
+    for(int p=0; p<nBodyParts; p++)
+    {
+        MockControlBoard *mock=0;
+        if(drivers[p].dd->view(mock))
+            mock->clearCommands();
+    }
+
+    // the joints that refused the direct mode (approachFrame) stay in position
+    int substeps=1;
+    if(!opt.directMode)
+    {
+        for(int p=0; p<nBodyParts; p++)
+            for(int j=0; j<bodyPartSize[p]; j++)
+                drivers[p].ictrl->setControlMode(j,VOCAB_CM_POSITION);
+    }
+    else
+    {
+        // the direct mode has no trajectory generator: the frames are
+        // interpolated so that the references are streamed at directRate
+        if(rate<opt.directRate)
+            substeps=(int)ceil(opt.directRate/rate);
+        if(opt.verbosity>=1) cout<<"Streaming at "<<rate*substeps<<" Hz"<<endl;
+    }
+
+    // in real-time mode the memory is locked before the threads are
+    // created, so that their stacks are locked too
+    if(opt.realTime.enabled)
+    {
+        lockProcessMemory();
+        cout<<"Real-time playing: SCHED_FIFO "<<opt.realTime.priority;
+        for(size_t k=0; k<opt.realTime.cpus.size(); k++)
+            cout<<(k==0 ? ", cpus " : ",")<<opt.realTime.cpus[k];
+        cout<<endl;
+    }
+
+    PartDispatcher dispatcher(player, opt.directMode, opt.concurrentDispatch, opt.realTime);
+    PeriodicScheduler scheduler(1.0/(rate*substeps), opt.overrunPolicy, *clock);
+    Playback play;
+    play.trajectory=&traj;
+    play.dispatcher=&dispatcher;
+    play.scheduler=&scheduler;
+    play.first=opt.first;
+    play.substeps=substeps;
+    play.progress=(opt.verbosity>=1 && !opt.realTime.enabled);
+
+    TrackingMonitor tracking;
+    play.encoders=(encodersRunning ? encoderReader : 0);
+    play.pollEncoders=clock->isVirtual();
+    play.tracking=&tracking;
+    if(!encodersRunning)
+        cout<<"Warning: no encoders, the tracking error is not measured"<<endl;
+
+    // commands from the rpc port, handed to the loop without locking
+    PlayerCommandQueue commands;
+    PlayerStatus status;
+    PlayerRpc rpc(opt.rpcName, traj.numberOfFrames(), commands, status);
+    play.commands=0;
+    play.status=0;
+    play.seekSpeed=opt.approachSpeed;
+    LoopTiming timing;
+    play.limits=&limits;
+    play.timing=&timing;
+    play.measurePeriod=!clock->isVirtual();
+    play.clock=clock;
+    if(!opt.rpcName.empty())
+    {
+        if(rpc.start())
+        {
+            play.commands=&commands;
+            play.status=&status;
+            if(opt.verbosity>=1) cout<<"Commands on "<<opt.rpcName<<endl;
+        }
+        else
+            cout<<"Warning: no rpc port, the trajectory is played to the end"<<endl;
+    }
+
+    // written by its own thread; on a virtual clock the loop waits for it
+    TelemetryRecorder telemetry;
+    play.telemetry=0;
+    if(!opt.telemetryFile.empty())
+    {
+        if(telemetry.open(opt.telemetryFile, rate*substeps, opt.telemetryEncoders, 8192, clock->isVirtual()))
+            play.telemetry=&telemetry;
+        else
+            cout<<"Warning: no telemetry"<<endl;
+    }
+
+    double wallStart=Time::now();
+    if(opt.realTime.enabled)
+    {
+        PlaybackThread playback(play, opt.realTime);
+        playback.start();
+        // stop() waits for run() to return
+        playback.stop();
+    }
+    else
+        playTrajectory(play);
+
+    double playingTime=scheduler.elapsed();
+    double wallTime=Time::now()-wallStart;
+    if(play.commands)
+        rpc.stop();
+    if(encoderReader->isRunning())
+        encoderReader->stop();
+    encodersRunning=false;
+    if(play.telemetry)
+        telemetry.close();
+    clock->delay(1.0);
+
+    cout<<"\n******  FINISHED! ****** "<<endl
+        <<"\nYou violated the joints limits x"<<limitsReport.totalViolations<<" times"<<endl;
+    cout<<"Played in "<<playingTime<<" s for "<<(traj.numberOfFrames()-opt.first)*substeps*scheduler.period()<<" s of trajectory, "
+        <<scheduler.overruns()<<" late frames (worst "<<scheduler.worstLateness()*1000.0<<" ms), "
+        <<scheduler.skippedTicks()<<" skipped"<<endl;
+    if(clock->isVirtual())
+        cout<<"Virtual clock: "<<wallTime<<" s of wall time, "<<playingTime/max(wallTime, 1e-9)<<" times faster than real time"<<endl;
+    cout<<"Skew between the first and the last part: mean "<<dispatcher.meanSkew()*1000.0<<" ms, worst "
+        <<dispatcher.worstSkew()*1000.0<<" ms ("<<(opt.concurrentDispatch ? "concurrent" : "sequential")<<" dispatch)"<<endl;
+    if(play.encoders)
+        printTrackingReport(tracking);
+    if(play.saturatedCommands>0)
+        cout<<"WARNING: "<<play.saturatedCommands<<" commands of the loop saturated to the joint limits"<<endl;
+    printLoopTiming(timing);
+    if(play.telemetry)
+    {
+        cout<<"Telemetry: "<<telemetry.numberOfRecords()<<" records written to "<<opt.telemetryFile;
+        if(telemetry.droppedRecords()>0)
+            cout<<", "<<telemetry.droppedRecords()<<" dropped (ring full)";
+        cout<<endl;
+    }
+    MockCommandReport commandsSent;
+    if(commandReport(commandsSent))
+    {
+        cout<<"Commands recorded by the boards: "<<commandsSent.commands-commandsSent.dropped<<" in "<<commandsSent.sends
+            <<" sends, every "<<commandsSent.meanInterval*1000.0<<" ms (worst "<<commandsSent.worstInterval*1000.0<<" ms)";
+        if(commandsSent.dropped>0)
+            cout<<", "<<commandsSent.dropped<<" dropped (buffer full)";
+        cout<<endl;
+    }
+    if(!opt.timingFile.empty() && writeLoopTiming(opt.timingFile, timing) && opt.verbosity>=1)
+        cout<<"Loop timing written to "<<opt.timingFile<<endl;
+    if(forbiddenAllocations()>0)
+        cout<<"WARNING: "<<forbiddenAllocations()<<" memory allocations in the playing loop (the first ones are reported where they happened)"<<endl;
+
+    //go back to a normal position mode
+    if(opt.directMode)
+        for(int p=0; p<nBodyParts; p++)
+            for(int j=0; j<bodyPartSize[p]; j++)
+                drivers[p].ictrl->setControlMode(j,VOCAB_CM_POSITION);
+    return true;
+}
+
+bool TrajectoryPlayer::commandReport(MockCommandReport &report)
+{
+    report.commands=0;
+    report.dropped=0;
+    report.sends=0;
+    report.meanInterval=0.0;
+    report.worstInterval=0.0;
+    if(!opened)
+        return false;
+
+    // the mean over the intervals of all the parts
+    bool found=false;
+    double total=0.0;
+    int intervals=0;
+    for(int p=0; p<nBodyParts; p++)
+    {
+        MockControlBoard *mock=0;
+        if(!drivers[p].dd->view(mock))
+            continue;
+        MockCommandReport part=mock->commandReport();
+        report.commands+=part.commands;
+        report.dropped+=part.dropped;
+        report.sends+=part.sends;
+        report.worstInterval=max(report.worstInterval, part.worstInterval);
+        if(part.sends>1)
+        {
+            total+=part.meanInterval*(part.sends-1);
+            intervals+=part.sends-1;
+        }
+        found=true;
+    }
+    if(intervals>0)
+        report.meanInterval=total/intervals;
+    return found;
+}
+
+void TrajectoryPlayer::close()
+{
+    if(encoderReader)
+    {
+        if(encoderReader->isRunning())
+            encoderReader->stop();
+        encoderReader->~EncoderReader();
+        encoderReader=0;
+        encodersRunning=false;
+    }
+
+    if(opened && opt.verbosity>=1) cout << "Closing drivers" << endl;
+    for(int p=0; p<nBodyParts; p++)
+        if(drivers[p].dd) {delete drivers[p].dd; drivers[p].dd=0;}
+    opened=false;
+}
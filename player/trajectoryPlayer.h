@@ -0,0 +1,175 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#ifndef TRAJECTORY_PLAYER_H
+#define TRAJECTORY_PLAYER_H
+
+#include <string>
+#include <yarp/sig/Matrix.h>
+#include <yarp/sig/Vector.h>
+
+#include "humanData.h"
+#include "wholeBodyTrajectory.h"
+#include "jointLimits.h"
+#include "periodicScheduler.h"
+#include "partDispatcher.h"
+#include "partDrivers.h"
+#include "realTime.h"
+#include "encoderReader.h"
+#include "playerClock.h"
+#include "mockControlBoard.h"
+
+//---------------------------------------------------------
+// settings of a player, the defaults are the ones of bodyPlayer
+//---------------------------------------------------------
+struct TrajectoryPlayerOptions
+{
+    std::string robot;          // the control boards are /<robot>/<part>
+    std::string name;           // prefix of the local ports, one per player of a process
+    std::string device;         // of the parts: remote_controlboard, or mock_controlboard/sim_controlboard in process
+    std::string deviceFile;     // option "file" of the device if not empty, e.g. the servo parameters of sim_controlboard
+    bool virtualClock;          // the waits take no time (in-process parts only); same commands, faster
+    int verbosity;
+    int first;                  // starting frame
+    double rate;                // Hz, of the text files, and maximum of the others
+    double recordingRate;       // Hz, a recording directory is resampled at it, at its own rate if <=0
+    double directRate;          // Hz, minimum streaming rate in direct mode
+    OverrunPolicy overrunPolicy;
+    bool directMode;            // setPositions streamed, positionMove of every frame otherwise
+    bool concurrentDispatch;    // one thread per part
+    RealTimeOptions realTime;
+    double driversTimeout;      // seconds per attempt to open a part
+    int driversRetries;
+    double approachSpeed;       // deg/s, to the starting frame and to a seeked frame
+    std::string rpcName;        // rpc port for pause/resume/seek/speed/stop, none if empty
+    std::string timingFile;     // the histograms of the loop timing are written to it if not empty
+    std::string telemetryFile;  // every command of the loop is recorded in it if not empty (see telemetryRecorder.h)
+    bool telemetryEncoders;     // with the latest encoders
+
+    TrajectoryPlayerOptions();
+};
+
+//---------------------------------------------------------
+// the pipeline of bodyPlayer for one robot: the state is all in the
+// instance, so that several players with different trajectories (and
+// names) can run in one process. The steps are called in order:
+//   loadLimits (optional), load, open, retarget, check, approach, play
+//---------------------------------------------------------
+class TrajectoryPlayer
+{
+public:
+    TrajectoryPlayer(const TrajectoryPlayerOptions &options);
+    ~TrajectoryPlayer();
+
+    const TrajectoryPlayerOptions &options() const { return opt; }
+
+    // a joint limits file, or "robot" to read them from the control
+    // boards in open(); the sit-to-stand limits otherwise
+    bool loadLimits(const std::string &name);
+
+    // the human data (see loadHumanData), or a recording directory of
+    // yarpdatadumper (see robotData.h): its parts aligned at their own
+    // rate (or recordingRate), and played like the human data
+    bool load(const std::string &filename);
+
+    // the drivers of all the parts, with their first encoders
+    bool open();
+
+    // the whole-body trajectory: the human data (or the recording) on
+    // the encoders
+    bool retarget();
+
+    // the starting frame and the trajectory against the joint limits,
+    // both saturated; returns the violations of the starting frame
+    int check();
+
+    // minimum-jerk movement from the encoders to the starting frame
+    bool approach();
+
+    // the trajectory from the starting frame, then the reports; only
+    // right after an approach() that succeeded
+    bool play();
+
+    // the encoders thread and the drivers
+    void close();
+
+    const HumanData &humanData() const { return human; }
+    // Hz, of the frames loaded
+    double frameRate() const { return rate; }
+    const WholeBodyTrajectory &trajectory() const { return traj; }
+    const JointLimitsReport &jointLimitsReport() const { return limitsReport; }
+    // the starting frame of a part, after check()
+    const yarp::sig::Vector &startingCommand(BodyPart p) const { return command[p]; }
+    // the commands of the last play() recorded by the in-process boards,
+    // all the parts together; false with remote_controlboard
+    bool commandReport(MockCommandReport &report);
+    // the driver of a part after open(), e.g. to view its MockControlBoard
+    yarp::dev::PolyDriver *driver(BodyPart p) { return drivers[p].dd; }
+
+private:
+    TrajectoryPlayer(const TrajectoryPlayer &);
+    TrajectoryPlayer &operator=(const TrajectoryPlayer &);
+
+    bool loadRecording(const std::string &directory);
+
+    TrajectoryPlayerOptions opt;
+    VirtualClock virtualClock;
+    PlayerClock *clock;         // &virtualClock or the system clock
+    std::string limitsName;
+    JointLimits limits;
+    JointLimitsReport limitsReport;
+    HumanData human;
+    // a recording: one row per frame, the column of each played part
+    // (-1 if it was not recorded, the encoders are kept)
+    yarp::sig::Matrix recording;
+    int recordingColumn[nBodyParts];
+    double rate;
+    int nFrames;
+    WholeBodyTrajectory traj;
+
+    PartDrivers drivers[nBodyParts];
+    bool opened;
+    yarp::sig::Vector command[nBodyParts];
+    PlayerPart player[nBodyParts];
+    // over-aligned, so built in place when the drivers are open
+    alignas(EncoderReader) unsigned char encoderReaderStorage[sizeof(EncoderReader)];
+    EncoderReader *encoderReader;
+    bool encodersRunning;
+    bool approached;            // the robot is at the starting frame
+};
+
+//---------------------------------------------------------
+// the steps, on their own
+//---------------------------------------------------------
+
+// the human data on the whole-body trajectory; the joints without
+// human data keep the encoders values
+bool loadHumanDataOnRobotTrajectory(const HumanData &human,
+                                    yarp::sig::Vector &q_RA, yarp::sig::Vector &q_LA, yarp::sig::Vector &q_T,
+                                    yarp::sig::Vector &q_RL, yarp::sig::Vector &q_LL,
+                                    WholeBodyTrajectory &traj);
+
+// the parts of a recording on the whole-body trajectory, column[p] is
+// the first column of part p in the recording, -1 to keep the encoders
+bool loadRecordingOnRobotTrajectory(const yarp::sig::Matrix &recording, const int column[nBodyParts],
+                                    const yarp::sig::Vector encoders[nBodyParts],
+                                    WholeBodyTrajectory &traj);
+
+// saturate a posture to the joint limits, returns the violations
+int safety_check(const JointLimits &limits, double *command_RA, double *command_LA, double *command_T,
+                 double *command_RL, double *command_LL);
+
+#endif
@@ -0,0 +1,64 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#include "wholeBodyTrajectory.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+const int bodyPartJoints[7] = { 0, 1, 2, 3, 4, 5, 6 };
+
+const char *bodyPartNames[nBodyParts] = { "right_arm", "left_arm", "torso", "right_leg", "left_leg" };
+
+const char *bodyJointNames[nBodyJoints] =
+{
+    "r_shoulder_pitch", "r_shoulder_roll", "r_shoulder_yaw", "r_elbow", "r_wrist_prosup", "r_wrist_pitch", "r_wrist_yaw",
+    "l_shoulder_pitch", "l_shoulder_roll", "l_shoulder_yaw", "l_elbow", "l_wrist_prosup", "l_wrist_pitch", "l_wrist_yaw",
+    "torso_yaw", "torso_roll", "torso_pitch",
+    "r_hip_pitch", "r_hip_roll", "r_hip_yaw", "r_knee", "r_ankle_pitch", "r_ankle_roll",
+    "l_hip_pitch", "l_hip_roll", "l_hip_yaw", "l_knee", "l_ankle_pitch", "l_ankle_roll"
+};
+
+//---------------------------------------------------------
+// WholeBodyTrajectory
+//---------------------------------------------------------
+WholeBodyTrajectory::WholeBodyTrajectory() : data(0), nFrames(0)
+{
+}
+
+WholeBodyTrajectory::~WholeBodyTrajectory()
+{
+    free(data);
+}
+
+bool WholeBodyTrajectory::resize(int n)
+{
+    free(data);
+    data = 0;
+    nFrames = 0;
+    if(n<=0)
+        return true;
+
+    size_t bytes = (size_t)n*frameStride*sizeof(double);
+    void *p;
+    if(posix_memalign(&p, 64, bytes)!=0)
+        return false;
+    memset(p, 0, bytes);
+
+    data = static_cast<double *>(p);
+    nFrames = n;
+    return true;
+}
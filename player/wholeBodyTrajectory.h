@@ -0,0 +1,81 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+/*
+* Copyright (C) 2016 INRIA for CODYCO Project
+* Author: Serena Ivaldi <serena.ivaldi@inria.fr>
+* website: www.codyco.eu
+*
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#ifndef WHOLE_BODY_TRAJECTORY_H
+#define WHOLE_BODY_TRAJECTORY_H
+
+#include <stddef.h>
+
+//---------------------------------------------------------
+// the parts played by bodyPlayer, in the order of a frame
+//---------------------------------------------------------
+enum BodyPart
+{
+    RIGHT_ARM=0,
+    LEFT_ARM,
+    TORSO,
+    RIGHT_LEG,
+    LEFT_LEG,
+    nBodyParts
+};
+
+// joints of each part in a frame, and where they start
+constexpr int bodyPartSize[nBodyParts]   = { 7, 7, 3, 6, 6 };
+constexpr int bodyPartOffset[nBodyParts] = { 0, 7, 14, 17, 23 };
+constexpr int nBodyJoints = 29;
+
+// indices 0..6 of the joints of a part, for the group commands
+extern const int bodyPartJoints[7];
+
+extern const char *bodyPartNames[nBodyParts];
+
+// the iCub names of the joints of a frame, in its order (e.g. r_shoulder_pitch)
+extern const char *bodyJointNames[nBodyJoints];
+
+//---------------------------------------------------------
+// whole-body trajectory, frame-major: the 29 joints of frame t are
+// contiguous and every frame starts on a cache line, so a part of a
+// frame is just a pointer into the buffer
+//---------------------------------------------------------
+class WholeBodyTrajectory
+{
+public:
+    // doubles between two frames: 29 joints padded to 4 cache lines
+    static const int frameStride = 32;
+
+    WholeBodyTrajectory();
+    ~WholeBodyTrajectory();
+
+    // nFrames zeroed frames; false if the allocation failed
+    bool resize(int nFrames);
+
+    int numberOfFrames() const { return nFrames; }
+
+    double *frame(int t) { return data+(size_t)t*frameStride; }
+    const double *frame(int t) const { return data+(size_t)t*frameStride; }
+
+    double *part(int t, BodyPart p) { return frame(t)+bodyPartOffset[p]; }
+    const double *part(int t, BodyPart p) const { return frame(t)+bodyPartOffset[p]; }
+
+private:
+    WholeBodyTrajectory(const WholeBodyTrajectory &);
+    WholeBodyTrajectory &operator=(const WholeBodyTrajectory &);
+
+    double *data;
+    int nFrames;
+};
+
+#endif